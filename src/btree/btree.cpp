@@ -1,12 +1,39 @@
 #include "btree.h"
 #include "../algo/search.h"
+#include <algorithm>
+
+namespace __impl
+{
+	// raw bytes of keys, for the adaptive index
+	inline const char *key_addr(const int &key) { return (const char*)&key; }
+	inline const char *key_addr(const char *key) { return key; }
+
+	template<typename KeyType> KeyType key_from(const char *addr);
+	template<> inline int key_from<int>(const char *addr)
+	{
+		int key;
+		std::memcpy(&key, addr, sizeof(int));
+		return key;
+	}
+
+	template<> inline const char *key_from<const char*>(const char *addr)
+	{
+		return addr;
+	}
+}
 
 template<typename KeyType, typename Comparer, typename Copier>
 btree<KeyType, Comparer, Copier>::btree(
 		pager *pg, int root_page_id, int field_size,
 		Comparer compare, Copier copier)
 	: pg(pg), root_page_id(root_page_id),
-	  field_size(field_size), compare(compare), copy_to_temp(copier)
+	  field_size(field_size), compare(compare), copy_to_temp(copier),
+	  ahi([this](const std::string &a, const std::string &b) {
+		return this->compare(
+			__impl::key_from<KeyType>(a.data()),
+			__impl::key_from<KeyType>(b.data())) < 0;
+	  }),
+	  hint_pid(0), hint_version(0)
 {
 	if(root_page_id == 0)
 	{
@@ -38,6 +65,9 @@ template<typename KeyType, typename Comparer, typename Copier>
 void btree<KeyType, Comparer, Copier>::insert(
 		key_t key, const char *data, int data_size)
 {
+	if(insert_hint(key, data, data_size))
+		return;
+
 	char *addr = pg->read_for_write(root_page_id);
 	uint16_t magic = general_page::get_magic_number(addr);
 	if(magic == PAGE_FIXED)
@@ -71,10 +101,12 @@ btree<KeyType, Comparer, Copier>::insert_post_process(
 		bool succ_ins = page.insert(ch_pos + 1, ch_largest, ch_ret.upper_pid);
 		if(!succ_ins)
 		{
-			auto upper = page.split(pid);
+			// see insert_leaf for appending to the right-most page
+			bool append = ch_pos + 1 == page.size() && !page.next_page();
+			auto upper = append ? page.append_page(pid) : page.split(pid);
 			Page upper_page = upper.second;
 			Page lower_page = page;
-			if(ch_pos < lower_page.size())
+			if(!append && ch_pos < lower_page.size())
 			{
 				succ_ins = lower_page.insert(
 					ch_pos + 1, ch_largest, ch_ret.upper_pid);
@@ -154,7 +186,13 @@ btree<KeyType, Comparer, Copier>::insert_leaf(
 
 	if(!succ_ins)
 	{
-		auto upper = page.split(now);
+		/* Appending to the right-most leaf starts a new leaf instead of
+		 * splitting it, so that leaves (and their parents) filled by
+		 * ascending keys are left full rather than half full. */
+		auto upper = ch_pos == page.size() && !page.next_page()
+			? page.append_page(now) : page.split(now);
+		ahi_invalidate(now);
+		ahi_invalidate(upper.first);
 
 		leaf_page upper_page = upper.second;
 		leaf_page lower_page = page;
@@ -167,6 +205,7 @@ btree<KeyType, Comparer, Copier>::insert_leaf(
 			succ_ins = upper_page.insert(
 				ch_pos - lower_page.size(), data, data_size);
 			assert(succ_ins);
+			now = upper.first;
 		}
 
 		ret.split = true;
@@ -175,13 +214,39 @@ btree<KeyType, Comparer, Copier>::insert_leaf(
 		ret.upper_pid  = upper.first;
 	}
 
+	hint_pid = now;
+	hint_version = page_version[now];
 	return ret;
 }
 
+template<typename KeyType, typename Comparer, typename Copier>
+bool btree<KeyType, Comparer, Copier>::insert_hint(
+	key_t key, const char *data, int data_size)
+{
+	if(hint_pid == 0 || page_version[hint_pid] != hint_version)
+		return false;
+
+	leaf_page page { pg->read_for_write(hint_pid), pg };
+	if(page.size() == 0 || compare(page.get_key(0), key) > 0)
+		return false;
+	if(page.next_page() && compare(page.get_key(page.size() - 1), key) <= 0)
+		return false;
+
+	int pos = ::lower_bound(0, page.size(), [&](int id) {
+		return compare(page.get_key(id), key) < 0;
+	} );
+
+	// fall back to the normal insertion when the leaf is to be split
+	return page.insert(pos, data, data_size);
+}
+
 template<typename KeyType, typename Comparer, typename Copier>
 typename btree<KeyType, Comparer, Copier>::search_result 
 btree<KeyType, Comparer, Copier>::lower_bound(key_t key)
 {
+	search_result ret;
+	if(ahi_lookup(key, &ret))
+		return ret;
 	return lower_bound(root_page_id, key);
 }
 
@@ -189,7 +254,7 @@ template<typename KeyType, typename Comparer, typename Copier>
 typename btree<KeyType, Comparer, Copier>::search_result
 btree<KeyType, Comparer, Copier>::lower_bound(int now, key_t key)
 {
-	char *addr = pg->read_for_write(now);
+	char *addr = pg->read(now);
 	uint16_t magic = general_page::get_magic_number(addr);
 	if(magic == PAGE_FIXED)
 	{
@@ -207,6 +272,9 @@ btree<KeyType, Comparer, Copier>::lower_bound(int now, key_t key)
 			return compare(page.get_key(id), key) < 0;
 		} );
 
+		if(now != root_page_id)
+			ahi_record(now, page);
+
 		if(pos == page.size())
 			return { 0, 0 };
 		else return { now, pos };
@@ -215,133 +283,239 @@ btree<KeyType, Comparer, Copier>::lower_bound(int now, key_t key)
 
 template<typename KeyType, typename Comparer, typename Copier>
 template<typename Page>
-typename btree<KeyType, Comparer, Copier>::merge_ret
-btree<KeyType, Comparer, Copier>::erase_try_merge(int pid, char *addr)
+void btree<KeyType, Comparer, Copier>::rebalance(int now, int pos)
 {
-	Page page { addr, pg };
-
-	if(page.underflow())
+	for(;;)
 	{
-		char *next_addr = nullptr, *prev_addr = nullptr;
-		if(page.next_page())
+		interior_page page { pg->read_for_write(now), pg };
+		int pid = page.get_child(pos);
+		Page child { pg->read_for_write(pid), pg };
+		ahi_invalidate(pid);
+
+		if(child.size() == 0)
 		{
-			next_addr = pg->read(page.next_page());
-			Page next_page { next_addr, pg };
-			if(!next_page.underflow_if_remove(0))
-			{
-				pg->mark_dirty(page.next_page());
-				page.move_from(next_page, 0, page.size());
-				return { false, false, 0 };
-			}
+			// unlink the empty child from its level
+			if(child.prev_page())
+				Page { pg->read_for_write(child.prev_page()), pg }.next_page_ref() = child.next_page();
+			if(child.next_page())
+				Page { pg->read_for_write(child.next_page()), pg }.prev_page_ref() = child.prev_page();
+			pg->free_page(pid);
+			page.erase(pos);
+			return;
 		}
 
-		if(page.prev_page())
+		page.set_key(pos, copy_to_temp(child.get_key(child.size() - 1)));
+		if(!child.underflow() || page.size() == 1)
+			return;
+
+		// only siblings under the same parent are used, so that
+		// the keys of other interior pages are kept untouched
+		int sib_pos = pos + 1 < page.size() ? pos + 1 : pos - 1;
+		int sib_pid = page.get_child(sib_pos);
+		Page sib { pg->read_for_write(sib_pid), pg };
+		ahi_invalidate(sib_pid);
+
+		while(child.underflow())
 		{
-			prev_addr = pg->read(page.prev_page());
-			Page prev_page { prev_addr, pg };
-			if(!prev_page.underflow_if_remove(prev_page.size() - 1))
-			{
-				pg->mark_dirty(page.prev_page());
-				page.move_from(prev_page, prev_page.size() - 1, 0);
-				return { false, false, 0 };
-			}
+			int src = sib_pos > pos ? 0 : sib.size() - 1;
+			if(sib.size() == 0 || sib.underflow_if_remove(src))
+				break;
+			child.move_from(sib, src, sib_pos > pos ? child.size() : 0);
 		}
 
-		if(next_addr)
+		if(!child.underflow())
 		{
-			int next_pid = page.next_page();
-			bool succ_merge = page.merge( { next_addr, pg }, pid);
-			UNUSED(succ_merge);
-			assert(succ_merge);
-			pg->free_page(next_pid);
-			return { false, true, pid };
-		} else if(prev_addr) {
-			int prev_pid = page.prev_page();
-			Page prev_page { prev_addr, pg };
-			bool succ_merge = prev_page.merge(page, prev_pid);
-			UNUSED(succ_merge);
-			assert(succ_merge);
-			pg->free_page(pid);
-			return { true, false, prev_pid };
+			page.set_key(pos, copy_to_temp(child.get_key(child.size() - 1)));
+			if(sib.size() != 0)
+				page.set_key(sib_pos, copy_to_temp(sib.get_key(sib.size() - 1)));
+			return;
 		}
-	} 
 
-	return { false, false, 0 };
+		int lo = std::min(pos, sib_pos), hi = std::max(pos, sib_pos);
+		int lo_pid = page.get_child(lo), hi_pid = page.get_child(hi);
+		Page lower { pg->read_for_write(lo_pid), pg };
+		bool succ_merge = lower.merge({ pg->read_for_write(hi_pid), pg }, lo_pid);
+		UNUSED(succ_merge);
+		assert(succ_merge);
+		pg->free_page(hi_pid);
+
+		page = interior_page { pg->read_for_write(now), pg };
+		page.erase(hi);
+		page.set_key(lo, copy_to_temp(lower.get_key(lower.size() - 1)));
+		// the left sibling is rebalanced later if it is touched, so
+		// that the positions before `pos' are kept for the caller
+		if(lo != pos) return;
+	}
 }
 
 template<typename KeyType, typename Comparer, typename Copier>
-typename btree<KeyType, Comparer, Copier>::erase_ret
-btree<KeyType, Comparer, Copier>::erase(int now, key_t key)
+int btree<KeyType, Comparer, Copier>::erase(int now, const key_t *first, const key_t *last)
 {
 	char *addr = pg->read_for_write(now);
 	uint16_t magic = general_page::get_magic_number(addr);
 	if(magic == PAGE_FIXED)
 	{
-		interior_page page { addr, pg };
-		int ch_pos = ::lower_bound(0, page.size(), [&](int id) {
-			return compare(page.get_key(id), key) < 0;
-		} );
-
-		ch_pos = std::min(page.size() - 1, ch_pos);
-		erase_ret ret = erase(page.get_child(ch_pos), key);
+		// erase from each child with the keys falling in it, and
+		// rebalance the children when the whole batch is done
+		std::vector<int> touched;
+		int erased = 0;
+		while(first != last)
+		{
+			interior_page page { pg->read_for_write(now), pg };
+			int ch_pos = ::lower_bound(0, page.size(), [&](int id) {
+				return compare(page.get_key(id), *first) < 0;
+			} );
+
+			ch_pos = std::min(page.size() - 1, ch_pos);
+			const key_t *mid = first + 1;
+			if(ch_pos == page.size() - 1) mid = last;
+			while(mid != last && compare(*mid, page.get_key(ch_pos)) <= 0)
+				++mid;
+
+			erased += erase(page.get_child(ch_pos), first, mid);
+			touched.push_back(ch_pos);
+			first = mid;
+		}
 
-		if(!ret.found) return ret;
+		// positions before the one being rebalanced are not moved
+		bool leaf = false;
+		if(!touched.empty())
+		{
+			interior_page page { pg->read(now), pg };
+			uint16_t ch_magic = general_page::get_magic_number(
+				pg->read(page.get_child(touched[0])));
+			leaf = ch_magic != PAGE_FIXED;
+		}
 
-		addr = pg->read_for_write(now);
-		page = interior_page { addr, pg };
-		if(ret.merged_right)
+		for(auto it = touched.rbegin(); it != touched.rend(); ++it)
 		{
-			page.erase(ch_pos + 1);
-			page.set_key(ch_pos, ret.largest);
-			page.set_child(ch_pos, ret.merged_pid);
-		} else if(ret.merged_left) {
-			page.erase(ch_pos);
-			page.set_key(ch_pos - 1, ret.largest);
-			page.set_child(ch_pos - 1, ret.merged_pid);
-		} else {
-			page.set_key(ch_pos, ret.largest);
+			if(leaf) rebalance<leaf_page>(now, *it);
+			else rebalance<interior_page>(now, *it);
 		}
 
-		merge_ret mret = erase_try_merge<interior_page>(now, addr);
-		return { true, mret.merged_left, mret.merged_right,
-			mret.merged_pid, copy_to_temp(page.get_key(page.size() - 1)) };
+		return erased;
 	} else {
 		assert(magic == PAGE_VARIANT || magic == PAGE_INDEX_LEAF);
 		leaf_page page { addr, pg };
-		int pos = ::lower_bound(0, page.size(), [&](int id) {
-			return compare(page.get_key(id), key) < 0;
-		} );
-
-		if(pos == page.size() || compare(page.get_key(pos), key) != 0)
-			return { false, false, false, 0, 0};
+		int erased = 0, pos = 0;
+		for(; first != last; ++first)
+		{
+			pos = ::lower_bound(pos, page.size(), [&](int id) {
+				return compare(page.get_key(id), *first) < 0;
+			} );
 
-		page.erase(pos);
-		auto ret = erase_try_merge<leaf_page>(now, addr);
+			if(pos != page.size() && compare(page.get_key(pos), *first) == 0)
+			{
+				page.erase(pos);
+				++erased;
+			}
+		}
 
-		return { true, ret.merged_left, ret.merged_right, ret.merged_pid,
-			now == root_page_id ? 0 : copy_to_temp(page.get_key(page.size() - 1)) };
+		return erased;
 	}
 }
 
 template<typename KeyType, typename Comparer, typename Copier>
-bool btree<KeyType, Comparer, Copier>::erase(key_t key)
+int btree<KeyType, Comparer, Copier>::erase_batch(std::vector<key_t> keys)
 {
-	erase_ret ret = erase(root_page_id, key);
+	if(keys.empty()) return 0;
+	std::sort(keys.begin(), keys.end(), [this](key_t a, key_t b) {
+		return compare(a, b) < 0;
+	} );
 
-	char *addr = pg->read_for_write(root_page_id);
-	uint16_t magic = general_page::get_magic_number(addr);
-	if(magic == PAGE_FIXED)
+	int erased = erase(root_page_id, keys.data(), keys.data() + keys.size());
+
+	for(;;)
 	{
+		char *addr = pg->read_for_write(root_page_id);
+		if(general_page::get_magic_number(addr) != PAGE_FIXED)
+			break;
 		interior_page page { addr, pg };
-		if(page.size() == 1 && page.get_child(0))
+		if(page.size() == 0)
 		{
-			debug_puts("B-tree merge root.");
-			pg->free_page(root_page_id);
-			root_page_id = page.get_child(0);
+			debug_puts("B-tree clear root.");
+			leaf_page { addr, pg }.init(field_size);
+			break;
 		}
+
+		if(page.size() != 1 || !page.get_child(0))
+			break;
+		debug_puts("B-tree merge root.");
+		int child = page.get_child(0);
+		pg->free_page(root_page_id);
+		root_page_id = child;
+	}
+
+	return erased;
+}
+
+template<typename KeyType, typename Comparer, typename Copier>
+bool btree<KeyType, Comparer, Copier>::erase(key_t key)
+{
+	return erase_batch(std::vector<key_t>(1, key)) != 0;
+}
+
+template<typename KeyType, typename Comparer, typename Copier>
+std::string btree<KeyType, Comparer, Copier>::ahi_key(key_t key)
+{
+	return std::string(__impl::key_addr(key), field_size);
+}
+
+template<typename KeyType, typename Comparer, typename Copier>
+bool btree<KeyType, Comparer, Copier>::ahi_lookup(key_t key, search_result *ret)
+{
+	if(ahi.empty()) return false;
+	auto it = ahi.lower_bound(ahi_key(key));
+	if(it == ahi.end()) return false;
+
+	int pid = it->second.pid;
+	if(page_version[pid] != it->second.version)
+	{
+		ahi.erase(it);
+		return false;
 	}
 
-	return ret.found;
+	// the key range of a leaf changes without splits when inserting
+	// or erasing at its ends, so check the key lies inside the leaf
+	leaf_page page { pg->read(pid), pg };
+	if(page.size() == 0
+		|| compare(page.get_key(0), key) >= 0
+		|| compare(page.get_key(page.size() - 1), key) < 0)
+		return false;
+
+	int pos = ::lower_bound(0, page.size(), [&](int id) {
+		return compare(page.get_key(id), key) < 0;
+	} );
+
+	*ret = { pid, pos };
+	return true;
+}
+
+template<typename KeyType, typename Comparer, typename Copier>
+void btree<KeyType, Comparer, Copier>::ahi_record(int pid, leaf_page page)
+{
+	if(page.size() == 0 || ++ahi_hits[pid] < AHI_HOT_LOOKUPS)
+		return;
+
+	ahi_hits.erase(pid);
+	if(ahi.size() >= AHI_MAX_PAGES)
+		ahi.clear();
+	ahi[ahi_key(page.get_key(page.size() - 1))] = { pid, page_version[pid] };
+}
+
+template<typename KeyType, typename Comparer, typename Copier>
+void btree<KeyType, Comparer, Copier>::ahi_invalidate(int pid)
+{
+	if(pid == 0) return;
+	++page_version[pid];
+	ahi_hits.erase(pid);
+}
+
+template<typename KeyType, typename Comparer, typename Copier>
+uint32_t btree<KeyType, Comparer, Copier>::get_page_version(int pid)
+{
+	auto it = page_version.find(pid);
+	return it == page_version.end() ? 0 : it->second;
 }
 
 /* Explicitly instantiate templates */
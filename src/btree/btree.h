@@ -7,8 +7,12 @@
 #include "../page/data_page.h"
 #include "../page/index_leaf_page.h"
 #include <functional>
+#include <map>
 #include <memory>
+#include <string>
 #include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 /* Each node of the b-tree is a page.
  * For an interior node, the key of a page element is the largest
@@ -38,10 +42,19 @@ public:
 	void insert(key_t key, const char* data, int data_size);
 	// erase one of the elements with specified key randomly
 	bool erase(key_t key);
+	/* erase one element for each of the keys, return the number erased
+	 * The keys are sorted and the leaves are visited once in order,
+	 * with underflowed pages rebalanced after the whole batch. */
+	int erase_batch(std::vector<key_t> keys);
 	// the first element x for which x >= key
 	search_result lower_bound(key_t key);
 
 	int get_root_page_id() { return root_page_id; }
+	// the leaf of the last insertion
+	int get_last_insert_page() { return hint_pid; }
+	// in-memory version of a page, bumped when its elements are moved by
+	// splits and merges
+	uint32_t get_page_version(int pid);
 
 private:
 	struct insert_ret
@@ -51,20 +64,6 @@ private:
 		char *lower_half, *upper_half;
 	};
 
-	struct erase_ret
-	{
-		bool found;
-		bool merged_left, merged_right;
-		int merged_pid;
-		key_t largest;
-	};
-
-	struct merge_ret
-	{
-		bool merged_left, merged_right;
-		int merged_pid;
-	};
-
 	template<typename Page, typename ChPage>
 	insert_ret insert_post_process(int, int, int, insert_ret);
 	template<typename Page>
@@ -72,9 +71,38 @@ private:
 	insert_ret insert_interior(int, char*, key_t, const char*, int);
 	insert_ret insert_leaf(int, char*, key_t, const char*, int);
 	search_result lower_bound(int now, key_t key);
-	erase_ret erase(int, key_t);
+	int erase(int, const key_t*, const key_t*);
 	template<typename Page>
-	merge_ret erase_try_merge(int pid, char *addr);
+	void rebalance(int pid, int pos);
+
+	/* Adaptive index of hot leaves.
+	 * A leaf reached by AHI_HOT_LOOKUPS descents is remembered by its
+	 * largest key, and later lookups falling in its key range go to it
+	 * directly. Splits and merges bump the in-memory version of the
+	 * pages involved, which invalidates the cached ones. */
+	struct ahi_page
+	{
+		int pid;
+		uint32_t version;
+	};
+
+	std::map<std::string, ahi_page, std::function<bool(const std::string&, const std::string&)>> ahi;
+	std::unordered_map<int, int> ahi_hits;
+	std::unordered_map<int, uint32_t> page_version;
+	std::string ahi_key(key_t key);
+	bool ahi_lookup(key_t key, search_result *ret);
+	void ahi_record(int pid, leaf_page page);
+	void ahi_invalidate(int pid);
+
+	/* Leaf of the last insertion.
+	 * Keys falling inside it, or beyond the right-most leaf, are inserted
+	 * there without descending from the root, so that appends and sorted
+	 * batches touch each leaf once. Appending to the right-most leaf
+	 * leaves the largest keys of its parents behind, which is harmless
+	 * as the last child takes all the keys beyond them. */
+	int hint_pid;
+	uint32_t hint_version;
+	bool insert_hint(key_t key, const char *data, int data_size);
 };
 
 class int_btree : public btree<int, int(*)(int, int), int(*)(int)>
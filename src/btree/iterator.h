@@ -19,7 +19,8 @@ private:
 		if(p)
 		{
 			PageType page { pg->read(p), pg };
-			assert(page.magic() == PAGE_VARIANT || page.magic() == PAGE_INDEX_LEAF);
+			assert(page.magic() == PAGE_VARIANT || page.magic() == PAGE_INDEX_LEAF
+				|| page.magic() == PAGE_HASH_BUCKET);
 			cur_size = page.size();
 			next_pid = page.next_page();
 			prev_pid = page.prev_page();
@@ -49,6 +50,15 @@ public:
 		return get();
 	}
 	
+	// skip the rest of the current page
+	value_t next_page()
+	{
+		assert(pid);
+		load_info(next_pid);
+		pos = 0;
+		return get();
+	}
+
 	value_t prev()
 	{
 		assert(pid);
@@ -25,7 +25,13 @@ void database::open(const char *db_name)
 	for(int i = 0; i < info.table_num; ++i)
 	{
 		tables[i] = new table_manager;
-		tables[i]->open(info.table_name[i]);
+		if(!tables[i]->open(info.table_name[i]))
+		{
+			// the table is left out, as if it did not exist
+			std::fprintf(stderr, "[Error] cannot open table `%s`.\n", info.table_name[i]);
+			delete tables[i];
+			tables[i] = nullptr;
+		}
 	}
 	opened = true;
 }
@@ -65,7 +71,7 @@ void database::create_table(const table_header_t *header)
 	if(!is_opened())
 	{
 		std::fprintf(stderr, "[Error] database not opened.\n");
-	} else if(get_table(header->table_name)) {
+	} else if(get_table_id(header->table_name) >= 0) {
 		std::fprintf(stderr, "[Error] table `%s` already exists.\n", header->table_name);
 	} else {
 		int id = info.table_num++;
@@ -81,6 +87,7 @@ void database::drop()
 	assert(is_opened());
 	for(int i = 0; i != info.table_num; ++i)
 	{
+		if(!tables[i]) continue;
 		tables[i]->drop();
 		delete tables[i];
 		tables[i] = nullptr;
@@ -132,8 +139,11 @@ void database::drop_table(const char *name)
 	}
 
 	--info.table_num;
-	tables[id]->drop();
-	delete tables[id];
+	if(tables[id])
+	{
+		tables[id]->drop();
+		delete tables[id];
+	}
 	for(int i = id; i < info.table_num; ++i)
 	{
 		tables[i] = tables[i + 1];
@@ -144,6 +154,16 @@ void database::drop_table(const char *name)
 	printf("OK!\n");
 }
 
+void database::release_rows()
+{
+	assert(is_opened());
+	for(int i = 0; i != info.table_num; ++i)
+	{
+		if(tables[i])
+			tables[i]->release_row();
+	}
+}
+
 void database::show_info()
 {
 	std::printf("======== Database Info Begin ========\n");
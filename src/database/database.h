@@ -35,6 +35,8 @@ public:
 	void drop_table(const char *name);
 	int get_table_id(const char *name);
 	void create_table(const table_header_t *header);
+	// unpin the pages of the records cached by the tables
+	void release_rows();
 	void show_info();
 };
 
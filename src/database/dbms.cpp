@@ -2,20 +2,56 @@
 #include "database.h"
 #include "../table/table.h"
 #include "../index/index.h"
+#include "../index/rid_bitmap.h"
 #include "../expression/expression.h"
+#include "../expression/compiled_expr.h"
 #include "../utils/type_cast.h"
+#include "../utils/key_encoder.h"
 #include "../table/record.h"
+#include "../table/bulk_loader.h"
+#include "result_exporter.h"
 #include <vector>
+#include <functional>
 #include <limits>
 #include <algorithm>
 #include <stdio.h>
+#include <strings.h>
 #include <iostream>
 #include <CppStringPlus/CppStringPlus.hpp>
+// unpin the pages of the records cached by a statement
 struct __cache_clear_guard
 {
-	~__cache_clear_guard() { expression::cache_clear(); }
+	database *db;
+	explicit __cache_clear_guard(database *db) : db(db) {}
+	~__cache_clear_guard() { db->release_rows(); }
 };
 
+// cache all columns again after a statement reading only some
+struct __cached_columns_guard
+{
+	std::vector<table_manager*> tables;
+	void set(table_manager *table, uint32_t cols)
+	{
+		table->set_cached_columns(cols);
+		tables.push_back(table);
+	}
+
+	~__cached_columns_guard()
+	{
+		for(table_manager *table : tables)
+			table->set_cached_columns(~0u);
+	}
+};
+
+// the cached records of the tables, to which expressions are bound
+static std::vector<const row_view*> get_rows(const std::vector<table_manager*> &tables)
+{
+	std::vector<const row_view*> rows;
+	for(table_manager *table : tables)
+		rows.push_back(table->get_row());
+	return rows;
+}
+
 dbms::dbms()
 	: output_file(stdout), cur_db(nullptr)
 {
@@ -42,7 +78,8 @@ template<typename Callback>
 void dbms::iterate(
 	std::vector<table_manager*> required_tables,
 	expr_node_t *cond,
-	Callback callback)
+	Callback callback,
+	uint32_t required_cols)
 {
 	if(required_tables.size() == 1)
 	{
@@ -52,7 +89,7 @@ void dbms::iterate(
 			rm_list[0] = rm;
 			rid_list[0] = rid;
 			return callback(required_tables, rm_list, rid_list);
-		} );
+		}, required_cols);
 	} else {
 		iterate_many_tables(required_tables, cond, callback);
 		std::puts("[Info] Join many tables by enumerating.");
@@ -63,17 +100,20 @@ template<typename Callback>
 bool dbms::iterate_one_table_with_index(
 		table_manager* table,
 		expr_node_t *cond,
-		Callback callback)
+		Callback callback,
+		uint32_t required_cols)
 {
 	std::vector<expr_node_t*> and_cond;
 	extract_and_cond(cond, and_cond);
 	expr_node_t *index_cond = nullptr;
 	index_manager *index = nullptr;
+	int index_cid = -1;
 
 	auto get_index = [&](column_ref_t *col) -> index_manager*
 	{
 		int cid = table->lookup_column(col->column);
 		if(cid < 0) return nullptr;
+		index_cid = cid;
 		return table->get_index(cid);
 	};
 
@@ -94,57 +134,695 @@ bool dbms::iterate_one_table_with_index(
 				}
 			}
 		}
-	}
+	}
+
+	// prefer a composite index matching more columns
+	if(iterate_one_table_with_composite_index(table, cond, and_cond,
+			index_cond ? 2 : 0, callback))
+		return true;
+
+	if(iterate_one_table_with_bitmap(table, cond, and_cond, callback))
+		return true;
+
+	if(!index_cond)
+	{
+		iterate_one_table(table, cond, callback);
+		return false;
+	}
+
+	char *key = get_index_key(index_cond->right);
+
+	// index-only scan if all required columns are stored in the index
+	bool index_only = (required_cols & ~table->get_index_covered(index_cid)) == 0;
+
+	// the conditions are compiled on the cached record
+	compiled_expr where(cond, table->get_row(), true);
+	auto it = index->get_equal_iterator(key);
+	if(!index_only)
+	{
+		bool eval_error = false;
+		auto visit = [&](record_manager *rm, int rid) -> bool {
+			bool ret = false;
+			try {
+				ret = where.eval_bool();
+			} catch(const char *msg) {
+				std::puts(msg);
+				eval_error = true;
+				return false;
+			}
+
+			return !ret || callback(table, rm, rid);
+		};
+
+		std::vector<int> rids;
+		while(!it.is_end())
+		{
+			rids.clear();
+			for(; !it.is_end() && rids.size() != MRR_BATCH_SIZE; it.next())
+				rids.push_back(index_manager::entry_rid(index->get_entry(it.get())));
+			if(!fetch_records(table, rids, visit))
+				break;
+		}
+
+		if(eval_error)
+		{
+			iterate_one_table(table, cond, callback);
+			return false;
+		}
+
+		return true;
+	}
+
+	compiled_expr index_where(index_cond, table->get_row(), true);
+	for(; !it.is_end(); it.next())
+	{
+		int rid;
+		table->cache_record_from_index(index_cid, it.get(), &rid);
+
+		bool join_ret = false, cond_ret = true;
+		try {
+			join_ret = index_where.eval_bool();
+			if(join_ret && cond != index_cond)
+				cond_ret = where.eval_bool();
+		} catch(const char *msg) {
+			std::puts(msg);
+			iterate_one_table(table, cond, callback);
+			return false;
+		}
+
+		if(!join_ret) break;
+		if(!cond_ret) continue;
+
+		if(!callback(table, nullptr, rid))
+			break;
+	}
+
+	return true;
+}
+
+template<typename Callback>
+bool dbms::iterate_one_table_with_bitmap(
+		table_manager* table,
+		expr_node_t *cond,
+		const std::vector<expr_node_t*> &and_cond,
+		Callback callback)
+{
+	// worth it for two or more conjuncts, or those which can not
+	// use a single b-tree or hash index otherwise
+	std::vector<expr_node_t*> probe_cond;
+	bool need_bitmap = false;
+	for(expr_node_t *expr : and_cond)
+	{
+		if(probe_index(table, expr, nullptr))
+		{
+			probe_cond.push_back(expr);
+			need_bitmap |= expr->op != OPERATOR_EQ
+				|| !table->get_index(get_probe_column(table, expr));
+		}
+	}
+
+	if(probe_cond.size() < 2 && !need_bitmap)
+		return false;
+
+	rid_bitmap result;
+	probe_index_and(table, probe_cond, result);
+
+	bool eval_error = false;
+	std::vector<int> rid_list;
+	result.to_vector(rid_list);
+	compiled_expr where(cond, table->get_row(), true);
+	fetch_records(table, rid_list, [&](record_manager *rm, int rid) -> bool {
+		bool ret = false;
+		try {
+			ret = where.eval_bool();
+		} catch(const char *msg) {
+			std::puts(msg);
+			eval_error = true;
+			return false;
+		}
+
+		return !ret || callback(table, rm, rid);
+	} );
+
+	if(eval_error)
+		iterate_one_table(table, cond, callback);
+	return true;
+}
+
+template<typename Callback>
+bool dbms::fetch_records(
+		table_manager *table,
+		std::vector<int> &rids,
+		Callback callback)
+{
+	// neighbouring rows mostly share a leaf of the record b-tree
+	if(!std::is_sorted(rids.begin(), rids.end()))
+		std::sort(rids.begin(), rids.end());
+
+	auto it = table->get_record_iterator_lower_bound(rids.empty() ? 0 : rids[0]);
+	for(int rid : rids)
+	{
+		if(!table->seek_record_iterator(it, rid))
+			continue;
+		record_manager rm(it.get_pager());
+		rm.open(it.get(), false);
+		table->cache_record(&rm);
+		if(!callback(&rm, rid))
+			return false;
+	}
+
+	return true;
+}
+
+template<typename Callback>
+bool dbms::iterate_one_table_with_composite_index(
+		table_manager* table,
+		expr_node_t *cond,
+		const std::vector<expr_node_t*> &and_cond,
+		int min_score,
+		Callback callback)
+{
+	// find `column op constant` for column `cid`, as if column is on the left
+	auto find_cond = [&](int cid, bool lower, bool upper, operator_type_t *op) -> expr_node_t*
+	{
+		for(expr_node_t *expr : and_cond)
+		{
+			if(expr->op != OPERATOR_EQ && expr->op != OPERATOR_LT && expr->op != OPERATOR_LEQ
+					&& expr->op != OPERATOR_GT && expr->op != OPERATOR_GEQ)
+				continue;
+
+			operator_type_t o = expr->op;
+			expr_node_t *col = expr->left, *val = expr->right;
+			if(col->term_type != TERM_COLUMN_REF)
+			{
+				std::swap(col, val);
+				switch(o)
+				{
+					case OPERATOR_LT:  o = OPERATOR_GT;  break;
+					case OPERATOR_LEQ: o = OPERATOR_GEQ; break;
+					case OPERATOR_GT:  o = OPERATOR_LT;  break;
+					case OPERATOR_GEQ: o = OPERATOR_LEQ; break;
+					default: break;
+				}
+			}
+
+			if(col->term_type != TERM_COLUMN_REF || col->op != OPERATOR_NONE
+					|| get_column_mask(table, col) != (1u << cid)
+					|| get_column_mask(table, val) != 0)
+				continue;
+
+			bool is_lower = o == OPERATOR_GT || o == OPERATOR_GEQ;
+			bool is_upper = o == OPERATOR_LT || o == OPERATOR_LEQ;
+			if((!lower && !upper && o == OPERATOR_EQ) || (lower && is_lower) || (upper && is_upper))
+			{
+				if(op) *op = o;
+				return val;
+			}
+		}
+
+		return nullptr;
+	};
+
+	// encode the constant as the normalized key of column `cid`
+	auto encode = [&](int cid, expr_node_t *expr, char *dest) -> bool
+	{
+		if(expr == nullptr) return false;
+		try {
+			expression val = expression::eval(expr);
+			int type = table->get_column_type(cid);
+			if(val.type == TERM_NULL || !typecast::type_compatible(type, val))
+				return false;
+			char *data = typecast::expr_to_db(val, typecast::column_to_term(type));
+			encode_sortable_key(type, table->get_column_length(cid), data, dest);
+			return true;
+		} catch(const char *) {
+			return false;
+		}
+	};
+
+	/* equality on the index columns from `first', and range on the next
+	 * one; the key of the columns before `first' is left zero */
+	auto match = [&](int i, int first, int &len, bool &found_upper, bool &inclusive,
+			std::vector<char> &lo, std::vector<char> &hi) -> int
+	{
+		int col_num = table->get_composite_col_num(i);
+		lo.assign(table->get_composite_key_size(i), 0);
+		hi.clear();
+		len = 0;
+		for(int j = 0; j != first; ++j)
+			len += sortable_key_length(table->get_column_length(table->get_composite_col(i, j)));
+
+		int eq = first;
+		for(; eq != col_num; ++eq)
+		{
+			int cid = table->get_composite_col(i, eq);
+			if(!encode(cid, find_cond(cid, false, false, nullptr), lo.data() + len))
+				break;
+			len += sortable_key_length(table->get_column_length(cid));
+		}
+
+		int score = (eq - first) * 2;
+		found_upper = false;
+		inclusive = true;
+		if(eq != col_num)
+		{
+			int cid = table->get_composite_col(i, eq);
+			operator_type_t op;
+			if(encode(cid, find_cond(cid, true, false, &op), lo.data() + len))
+				score |= 1;
+			hi.resize(sortable_key_length(table->get_column_length(cid)));
+			if(encode(cid, find_cond(cid, false, true, &op), hi.data()))
+			{
+				score |= 1;
+				found_upper = true;
+				// strings may be truncated in the key
+				inclusive = op == OPERATOR_LEQ
+					|| table->get_column_type(cid) == COL_TYPE_VARCHAR;
+			}
+		}
+
+		return score;
+	};
+
+	int best = -1, best_score = min_score, prefix_len = 0;
+	bool has_upper = false, upper_inclusive = true;
+	std::vector<char> lower_key, upper_key;
+	auto try_index = [&](int i, int first) -> bool
+	{
+		std::vector<char> lo, hi;
+		int len;
+		bool found_upper, inclusive;
+		int score = match(i, first, len, found_upper, inclusive, lo, hi);
+		if(score <= best_score)
+			return false;
+		best = i;
+		best_score = score;
+		prefix_len = len;
+		has_upper = found_upper;
+		upper_inclusive = inclusive;
+		lower_key.swap(lo);
+		upper_key.swap(hi);
+		return true;
+	};
+
+	for(int i = 0; i != table->get_composite_index_num(); ++i)
+		try_index(i, 0);
+
+	/* skip scan: no condition on the leading column, which has few
+	 * distinct values, so seek to the rest of the key in each group */
+	int skip_len = 0;
+	if(best < 0 && min_score == 0)
+	{
+		for(int i = 0; i != table->get_composite_index_num(); ++i)
+		{
+			if(table->get_composite_lead_ndv(i) > SKIP_SCAN_MAX_GROUPS)
+				continue;
+			if(try_index(i, 1))
+				skip_len = sortable_key_length(table->get_column_length(table->get_composite_col(i, 0)));
+		}
+	}
+
+	if(best < 0) return false;
+
+	compiled_expr where(cond, table->get_row(), true);
+	auto visit = [&](record_manager *rm, int rid) -> bool {
+		bool ret = false;
+		try {
+			ret = where.eval_bool();
+		} catch(const char *msg) {
+			std::puts(msg);
+			return false;
+		}
+
+		return !ret || callback(table, rm, rid);
+	};
+
+	auto in_range = [&](const char *key) -> bool {
+		if(std::memcmp(key + skip_len, lower_key.data() + skip_len, prefix_len - skip_len) != 0)
+			return false;
+		if(has_upper)
+		{
+			int r = std::memcmp(key + prefix_len, upper_key.data(), upper_key.size());
+			return r < 0 || (r == 0 && upper_inclusive);
+		}
+
+		return true;
+	};
+
+	index_manager *index = table->get_composite_index(best);
+	auto it = index->get_iterator_lower_bound(lower_key.data());
+	std::vector<int> rids;
+	while(!it.is_end())
+	{
+		const char *key = index_manager::entry_key(index->get_entry(it.get()));
+		if(skip_len && std::memcmp(key, lower_key.data(), skip_len) != 0)
+		{
+			// entering the next group
+			std::memcpy(lower_key.data(), key, skip_len);
+			it = index->get_iterator_lower_bound(lower_key.data());
+			if(it.is_end()) break;
+		}
+
+		rids.clear();
+		bool group_end = false;
+		for(; !it.is_end() && rids.size() != MRR_BATCH_SIZE; it.next())
+		{
+			const char *entry = index->get_entry(it.get());
+			key = index_manager::entry_key(entry);
+			if(skip_len && std::memcmp(key, lower_key.data(), skip_len) != 0)
+				break;
+			if(!in_range(key))
+			{
+				group_end = true;
+				break;
+			}
+
+			rids.push_back(index_manager::entry_rid(entry));
+		}
+
+		if(!fetch_records(table, rids, visit))
+			break;
+
+		if(group_end)
+		{
+			if(!skip_len) break;
+			// a not-null mark is 0 or 1, so this is above any key of the group
+			std::vector<char> next(lower_key.begin(), lower_key.begin() + skip_len);
+			next.resize(lower_key.size(), (char)0xff);
+			it = index->get_iterator_lower_bound(next.data());
+		}
+	}
+
+	return true;
+}
+
+char *dbms::get_index_key(expr_node_t *val)
+{
+	switch(val->term_type)
+	{
+		case TERM_INT:
+		case TERM_DATE:
+			return (char*)&val->val_i;
+		case TERM_FLOAT:
+			return (char*)&val->val_f;
+		case TERM_STRING:
+			return val->val_s;
+		case TERM_BOOL:
+			return (char*)&val->val_b;
+		default:
+			return nullptr;
+	}
+}
+
+int dbms::get_probe_column(table_manager *table, expr_node_t *expr)
+{
+	if(expr->op != OPERATOR_EQ && expr->op != OPERATOR_IN)
+		return -1;
+	expr_node_t *col = expr->left, *val = expr->right;
+	if(expr->op == OPERATOR_EQ && col->term_type != TERM_COLUMN_REF)
+		std::swap(col, val);
+	if(col->op != OPERATOR_NONE || col->term_type != TERM_COLUMN_REF
+			|| val->op != OPERATOR_NONE || val->term_type == TERM_COLUMN_REF)
+		return -1;
+
+	uint32_t mask = get_column_mask(table, col);
+	if(mask == ~0u) return -1;
+	int cid = __builtin_ctz(mask);
+	if(!table->get_index(cid) && !table->get_bitmap_index(cid))
+		return -1;
+
+	// the key found in the index must be exactly the literal
+	auto key_matches = [&](const expr_node_t *v) -> bool {
+		switch(table->get_column_type(cid))
+		{
+			case COL_TYPE_INT:
+				return v->term_type == TERM_INT;
+			case COL_TYPE_FLOAT:
+				return v->term_type == TERM_FLOAT;
+			case COL_TYPE_VARCHAR:
+				return v->term_type == TERM_STRING
+					&& (int)std::strlen(v->val_s) <= table->get_column_length(cid);
+			default:
+				return false;
+		}
+	};
+
+	if(expr->op == OPERATOR_EQ)
+		return key_matches(val) ? cid : -1;
+	if(val->term_type != TERM_LITERAL_LIST)
+		return -1;
+	for(linked_list_t *l = val->literal_list; l; l = l->next)
+		if(!key_matches((expr_node_t*)l->data))
+			return -1;
+	return cid;
+}
+
+bool dbms::probe_index(table_manager *table, expr_node_t *expr, rid_bitmap *rids)
+{
+	if(expr->op == OPERATOR_OR)
+	{
+		if(!rids)
+			return probe_index(table, expr->left, nullptr)
+				&& probe_index(table, expr->right, nullptr);
+		rid_bitmap right;
+		probe_index(table, expr->left, rids);
+		probe_index(table, expr->right, &right);
+		rids->union_with(right);
+		return true;
+	}
+
+	if(expr->op == OPERATOR_LIKE)
+	{
+		// candidates only, rows are rechecked by the caller
+		uint32_t mask = get_column_mask(table, expr->left);
+		if(expr->left->op != OPERATOR_NONE || mask == ~0u || mask == 0
+				|| expr->right->op != OPERATOR_NONE
+				|| expr->right->term_type != TERM_STRING)
+			return false;
+		trigram_index *trigram = table->get_trigram_index(__builtin_ctz(mask));
+		if(!trigram || !trigram_index::searchable(expr->right->val_s))
+			return false;
+		if(rids) trigram->search(expr->right->val_s, *rids);
+		return true;
+	}
+
+	int cid = get_probe_column(table, expr);
+	if(cid < 0) return false;
+	if(!rids) return true;
+
+	index_manager *index = table->get_index(cid);
+	bitmap_index *bitmap = table->get_bitmap_index(cid);
+	auto add_equal = [&](expr_node_t *v) {
+		if(bitmap)
+		{
+			const rid_bitmap *found = bitmap->find(get_index_key(v));
+			if(found) rids->union_with(*found);
+			return;
+		}
+
+		auto it = index->get_equal_iterator(get_index_key(v));
+		for(; !it.is_end(); it.next())
+			rids->add(index_manager::entry_rid(index->get_entry(it.get())));
+	};
+
+	expr_node_t *val = expr->left->term_type == TERM_COLUMN_REF ? expr->right : expr->left;
+	if(expr->op == OPERATOR_EQ)
+	{
+		add_equal(val);
+	} else {
+		for(linked_list_t *l = val->literal_list; l; l = l->next)
+			add_equal((expr_node_t*)l->data);
+	}
+
+	return true;
+}
+
+void dbms::probe_index_and(table_manager *table,
+	const std::vector<expr_node_t*> &and_cond, rid_bitmap &result)
+{
+	for(size_t i = 0; i != and_cond.size(); ++i)
+	{
+		rid_bitmap rids;
+		probe_index(table, and_cond[i], &rids);
+		if(i == 0) result = std::move(rids);
+		else result.intersect_with(rids);
+		if(result.empty()) break;
+	}
+}
+
+bool dbms::count_with_index(table_manager *table, expr_node_t *cond, int *count)
+{
+	std::vector<expr_node_t*> and_cond;
+	extract_and_cond(cond, and_cond);
+	if(and_cond.empty()) return false;
+	// OR is left to the evaluator, where `TRUE OR NULL' is not true,
+	// and LIKE gives candidates only
+	for(expr_node_t *expr : and_cond)
+	{
+		if(expr->op == OPERATOR_OR || expr->op == OPERATOR_LIKE
+				|| !probe_index(table, expr, nullptr))
+			return false;
+	}
+
+	rid_bitmap result;
+	probe_index_and(table, and_cond, result);
+	*count = result.size();
+	return true;
+}
+
+uint32_t dbms::get_column_mask(table_manager *table, const expr_node_t *expr)
+{
+	if(!expr) return 0;
+	if(expr->op == OPERATOR_NONE)
+	{
+		if(expr->term_type != TERM_COLUMN_REF)
+			return 0;
+		column_ref_t *col = expr->column_ref;
+		if(col->table && std::strcmp(col->table, table->get_table_name()) != 0)
+			return ~0u;
+		int cid = table->lookup_column(col->column);
+		return cid < 0 ? ~0u : 1u << cid;
+	}
+
+	uint32_t mask = get_column_mask(table, expr->left);
+	if(!(expr->op & OPERATOR_UNARY))
+		mask |= get_column_mask(table, expr->right);
+	return mask;
+}
+
+uint32_t dbms::get_referenced_columns(table_manager *table, const expr_node_t *expr)
+{
+	if(!expr) return 0;
+	if(expr->op == OPERATOR_NONE)
+	{
+		if(expr->term_type != TERM_COLUMN_REF)
+			return 0;
+		column_ref_t *col = expr->column_ref;
+		if(col->table && std::strcmp(col->table, table->get_table_name()) != 0)
+			return 0;
+		int cid = table->lookup_column(col->column);
+		return cid < 0 ? 0 : 1u << cid;
+	}
+
+	uint32_t mask = get_referenced_columns(table, expr->left);
+	if(!(expr->op & OPERATOR_UNARY))
+		mask |= get_referenced_columns(table, expr->right);
+	return mask;
+}
+
+void dbms::get_zone_conds(table_manager *table, expr_node_t *cond,
+		std::vector<zone_map::cond_t> &conds)
+{
+	std::vector<expr_node_t*> and_cond;
+	extract_and_cond(cond, and_cond);
+	for(expr_node_t *expr : and_cond)
+	{
+		if(expr->op != OPERATOR_EQ && expr->op != OPERATOR_LT && expr->op != OPERATOR_LEQ
+				&& expr->op != OPERATOR_GT && expr->op != OPERATOR_GEQ)
+			continue;
+
+		operator_type_t op = expr->op;
+		expr_node_t *col = expr->left, *val = expr->right;
+		if(col->term_type != TERM_COLUMN_REF)
+		{
+			std::swap(col, val);
+			switch(op)
+			{
+				case OPERATOR_LT:  op = OPERATOR_GT;  break;
+				case OPERATOR_LEQ: op = OPERATOR_GEQ; break;
+				case OPERATOR_GT:  op = OPERATOR_LT;  break;
+				case OPERATOR_GEQ: op = OPERATOR_LEQ; break;
+				default: break;
+			}
+		}
+
+		if(col->op != OPERATOR_NONE || col->term_type != TERM_COLUMN_REF
+				|| val->op != OPERATOR_NONE || val->term_type == TERM_COLUMN_REF)
+			continue;
+
+		uint32_t mask = get_column_mask(table, col);
+		if(mask == ~0u) continue;
+		int cid = __builtin_ctz(mask);
+		if(!table->has_zone_map(cid))
+			continue;
+
+		// literals of other types are errors when evaluated
+		expression v;
+		try {
+			v = expression::eval(val);
+		} catch(const char *) {
+			continue;
+		}
+
+		zone_map::cond_t c { cid, op, { 0 } };
+		switch(table->get_column_type(cid))
+		{
+			case COL_TYPE_INT:
+				if(v.type != TERM_INT) continue;
+				c.val.i = v.val_i;
+				break;
+			case COL_TYPE_DATE:
+				if(v.type != TERM_DATE) continue;
+				c.val.i = v.val_i;
+				break;
+			case COL_TYPE_FLOAT:
+				if(v.type != TERM_FLOAT) continue;
+				c.val.f = v.val_f;
+				break;
+			default:
+				continue;
+		}
 
-	if(!index_cond)
-	{
-		iterate_one_table(table, cond, callback);
-		return false;
+		conds.push_back(c);
 	}
+}
 
-	char *key = nullptr;
-	switch(index_cond->right->term_type)
+bool dbms::get_dict_conds(table_manager *table, expr_node_t *cond,
+		std::vector<dict_cond_t> &conds)
+{
+	std::vector<expr_node_t*> and_cond;
+	extract_and_cond(cond, and_cond);
+	for(expr_node_t *expr : and_cond)
 	{
-		case TERM_INT:
-		case TERM_DATE:
-			key = (char*)&index_cond->right->val_i;
-			break;
-		case TERM_FLOAT:
-			key = (char*)&index_cond->right->val_f;
-			break;
-		case TERM_STRING:
-			key = index_cond->right->val_s;
-			break;
-		case TERM_BOOL:
-			key = (char*)&index_cond->right->val_b;
-			break;
-		default:
-			break;
-	}
+		if(expr->op != OPERATOR_EQ && expr->op != OPERATOR_NEQ
+				&& expr->op != OPERATOR_LIKE && expr->op != OPERATOR_IN)
+			continue;
 
-	auto it = index->get_iterator_lower_bound(key);
-	for(; !it.is_end(); it.next())
-	{
-		int rid;
-		record_manager rm = table->open_record_from_index_lower_bound(it.get(), &rid);
-		table->cache_record(&rm);
+		bool col_left = expr->left->term_type == TERM_COLUMN_REF;
+		expr_node_t *col = col_left ? expr->left : expr->right;
+		expr_node_t *val = col_left ? expr->right : expr->left;
+		if(col->op != OPERATOR_NONE || col->term_type != TERM_COLUMN_REF
+				|| val->op != OPERATOR_NONE || val->term_type == TERM_COLUMN_REF)
+			continue;
+
+		uint32_t mask = get_column_mask(table, col);
+		if(mask == ~0u) continue;
+		int cid = __builtin_ctz(mask);
+		dictionary *dict = table->get_dictionary(cid);
+		if(!dict) continue;
+
+		// the conjunct with the column replaced by each string
+		expr_node_t str, test = *expr;
+		str.op = OPERATOR_NONE;
+		str.term_type = TERM_STRING;
+		str.right = nullptr;
+		(col_left ? test.left : test.right) = &str;
 
-		bool join_ret = false;
+		dict_cond_t c { cid, std::vector<char>(dict->size()) };
 		try {
-			join_ret = typecast::expr_to_bool(expression::eval(index_cond));
-		} catch(const char *msg) {
-			std::puts(msg);
-			iterate_one_table(table, cond, callback);
-			return false;
+			for(int code = 0; code != dict->size(); ++code)
+			{
+				str.val_s = const_cast<char*>(dict->decode(code));
+				c.match[code] = typecast::expr_to_bool(expression::eval(&test));
+			}
+		} catch(const char *) {
+			continue;
 		}
 
-		if(!join_ret) break;
-
-		if(!callback(table, &rm, rid))
-			break;
+		conds.push_back(std::move(c));
 	}
 
-	return true;
+	return conds.size() == and_cond.size();
 }
 
 template<typename Callback>
@@ -153,19 +831,54 @@ void dbms::iterate_one_table(
 		expr_node_t *cond,
 		Callback callback)
 {
+	// leaves are skipped if their zone maps rule out a condition
+	std::vector<zone_map::cond_t> zone_conds;
+	get_zone_conds(table, cond, zone_conds);
+	// and the records of hot leaves by their column segments
+	bool by_column = false;
+	column_cache::selection_t sel;
+	// and by the codes of columns with dictionaries
+	std::vector<dict_cond_t> dict_conds;
+	bool all_dict = get_dict_conds(table, cond, dict_conds);
+	compiled_expr where(cond, table->get_row(), true);
+
 	auto bit = table->get_record_iterator_lower_bound(0);
 	for(; !bit.is_end(); bit.next())
 	{
+		int pos = bit.get().second;
+		if(!zone_conds.empty() && pos == 0)
+		{
+			while(!bit.is_end() && !table->leaf_may_match(bit.get().first, zone_conds))
+				bit.next_page();
+			if(bit.is_end()) break;
+			by_column = table->select_leaf(bit.get().first, zone_conds, sel);
+		}
+
+		if(by_column && !((sel[pos >> 6] >> (pos & 63)) & 1))
+			continue;
+
 		int rid;
 		record_manager rm(bit.get_pager());
 		rm.open(bit.get(), false);
 		rm.read(&rid, 4);
+
+		bool known = all_dict, rejected = false;
+		for(const dict_cond_t &c : dict_conds)
+		{
+			int code = table->read_code(&rm, c.cid);
+			if(code < 0 || code >= (int)c.match.size())
+				known = false;
+			else if(!c.match[code])
+				rejected = true;
+		}
+
+		if(rejected) continue;
 		table->cache_record(&rm);
-		if(cond)
+		if(cond && !known)
 		{
 			bool result = false;
 			try {
-				result = typecast::expr_to_bool(expression::eval(cond));
+				result = where.eval_bool();
 			} catch(const char *msg) {
 				std::puts(msg);
 				return;
@@ -319,10 +1032,23 @@ void dbms::iterate_many_tables(
 		assert(index_ref[i]);
 	}
 
+	// the conditions are compiled on the cached records of all tables
+	std::vector<const row_view*> rows = get_rows(table_list);
+	compiled_expr where(cond, rows, true);
+	std::vector<std::vector<compiled_expr>> join_conds(len, std::vector<compiled_expr>(len));
+	for(int i = 0; i < len; ++i)
+	{
+		for(int j = 0; j < len; ++j)
+		{
+			if(J[i][j])
+				join_conds[i][j] = compiled_expr(J[i][j], rows, true);
+		}
+	}
+
 	iterate_many_tables_impl(
 		table_list, record_list, rid_list,
-		J, path, index_cid, index_ref,
-		cond, callback, len - 1);
+		join_conds, path, index_cid, index_ref,
+		where, callback, len - 1);
 
 	// debug info
 	std::printf("[Info] Iteration order: ");
@@ -358,17 +1084,17 @@ bool dbms::iterate_many_tables_impl(
 	const std::vector<table_manager*> &table_list,
 	std::vector<record_manager*> &record_list,
 	std::vector<int> &rid_list,
-	std::vector<std::vector<expr_node_t*>> &index_cond,
+	const std::vector<std::vector<compiled_expr>> &join_conds,
 	int *iter_order, int *index_cid, index_manager** index,
-	expr_node_t *cond, Callback callback, int now)
+	const compiled_expr &cond, Callback callback, int now)
 {
 	if(now < 0)
 	{
-		if(cond)
+		if(!cond.empty())
 		{
 			bool result = false;
 			try {
-				result = typecast::expr_to_bool(expression::eval(cond));
+				result = cond.eval_bool();
 			} catch(const char *msg) {
 				std::puts(msg);
 				return false; // stop
@@ -395,7 +1121,7 @@ bool dbms::iterate_many_tables_impl(
 				record_list[iter_order[now]] = &rm;
 				bool ret = iterate_many_tables_impl(
 					table_list, record_list, rid_list,
-					index_cond, iter_order, index_cid, index,
+					join_conds, iter_order, index_cid, index,
 					cond, callback, now - 1
 				);
 
@@ -404,34 +1130,41 @@ bool dbms::iterate_many_tables_impl(
 		} else {
 			const char *tb_col = table_list[iter_order[now + 1]]->get_cached_column(index_cid[now]);
 			table_manager *tb2 = table_list[iter_order[now]];
-			auto tb2_it = index[now]->get_iterator_lower_bound(tb_col);
-			for(; !tb2_it.is_end(); tb2_it.next())
-			{
-				int tb2_rid;
-				record_manager tb2_rm = tb2->open_record_from_index_lower_bound(tb2_it.get(), &tb2_rid);
-				tb2->cache_record(&tb2_rm);
-
+			bool stop = false;
+			auto visit = [&](record_manager *tb2_rm, int tb2_rid) -> bool {
 				bool join_ret = false;
 				try {
-					expr_node_t *join_cond = index_cond[iter_order[now]][iter_order[now + 1]];
-					join_ret = typecast::expr_to_bool(expression::eval(join_cond));
+					join_ret = join_conds[iter_order[now]][iter_order[now + 1]].eval_bool();
 				} catch(const char *msg) {
 					std::puts(msg);
+					stop = true;
 					return false;
 				}
 
-				if(!join_ret) break;
+				if(!join_ret) return true;
 
 				rid_list[iter_order[now]] = tb2_rid;
-				record_list[iter_order[now]] = &tb2_rm;
-				bool ret = iterate_many_tables_impl(
+				record_list[iter_order[now]] = tb2_rm;
+				stop = !iterate_many_tables_impl(
 					table_list, record_list, rid_list,
-					index_cond, iter_order, index_cid, index,
+					join_conds, iter_order, index_cid, index,
 					cond, callback, now - 1
 				);
 
-				if(!ret) return false;
+				return !stop;
+			};
+
+			auto tb2_it = index[now]->get_equal_iterator(tb_col);
+			std::vector<int> rids;
+			while(!tb2_it.is_end() && !stop)
+			{
+				rids.clear();
+				for(; !tb2_it.is_end() && rids.size() != MRR_BATCH_SIZE; tb2_it.next())
+					rids.push_back(index_manager::entry_rid(index[now]->get_entry(tb2_it.get())));
+				fetch_records(tb2, rids, visit);
 			}
+
+			if(stop) return false;
 		}
 	}
 
@@ -587,7 +1320,7 @@ void dbms::update_rows(const update_info_t *info, std::shared_ptr< SystemAbstrac
 	if(!assert_db_open())
 		return;
 
-	__cache_clear_guard __guard;
+	__cache_clear_guard __guard(cur_db);
 	table_manager *tm = cur_db->get_table(info->table);
 	if(tm == nullptr)
 	{
@@ -595,31 +1328,69 @@ void dbms::update_rows(const update_info_t *info, std::shared_ptr< SystemAbstrac
 		return;
 	}
 
-	int col_id = tm->lookup_column(info->column_ref->column);
-	if(col_id < 0)
+	// all the values are evaluated on the old record
+	std::vector<std::pair<int, compiled_expr>> items;
+	uint32_t cols = 0, referenced = get_referenced_columns(tm, info->where);
+	for(linked_list_t *l = info->items; l; l = l->next)
 	{
-		std::fprintf(stderr, "[Error] column `%s' not exists.\n", info->column_ref->column);
-		return;
+		auto item = (update_item_t*)l->data;
+		int col_id = tm->lookup_column(item->column_ref->column);
+		if(col_id < 0)
+		{
+			std::fprintf(stderr, "[Error] column `%s' not exists.\n", item->column_ref->column);
+			return;
+		}
+
+		if(cols & (1u << col_id))
+		{
+			std::fprintf(stderr, "[Error] column `%s' is assigned twice.\n", item->column_ref->column);
+			return;
+		}
+
+		cols |= 1u << col_id;
+		referenced |= get_referenced_columns(tm, item->value);
+		items.emplace_back(col_id, compiled_expr(item->value, tm->get_row()));
 	}
 
-	int succ_count = 0, fail_count = 0;
-	try {
-		iterate_one_table(tm, info->where, [&](table_manager *tm, record_manager *, int rid) -> bool {
-			expression val = expression::eval(info->value);
-			int col_type = tm->get_column_type(col_id);
-			if(!typecast::type_compatible(col_type, val))
-				throw "[Error] Incompatible data type.";
-			auto term_type = typecast::column_to_term(col_type);
-			bool ret = tm->modify_record(rid, col_id, typecast::expr_to_db(val, term_type));
-			succ_count += ret;
-			fail_count += 1 - ret;
+	__cached_columns_guard __cols_guard;
+	__cols_guard.set(tm, referenced);
+
+	// the records are collected first, as modified ones may be moved
+	std::vector<int> rids;
+	iterate_one_table_with_index(tm, info->where,
+		[&rids](table_manager*, record_manager*, int rid) -> bool {
+			rids.push_back(rid);
 			return true;
-		} );
-	} catch(const char *msg) {
-		std::puts(msg);
+		}, get_column_mask(tm, info->where));
+
+	const char *error = nullptr;
+	int succ_count = tm->modify_records(rids, cols, [&]() -> bool {
+		try {
+			for(auto &item : items)
+			{
+				expression val = item.second.eval();
+				int col_type = tm->get_column_type(item.first);
+				if(!typecast::type_compatible(col_type, val))
+					throw "[Error] Incompatible data type.";
+				auto term_type = typecast::column_to_term(col_type);
+				if(!tm->set_temp_record(item.first, typecast::expr_to_db(val, term_type)))
+					throw "[Error] string too long.";
+			}
+		} catch(const char *msg) {
+			error = msg;
+			return false;
+		}
+
+		return true;
+	} );
+
+	if(error)
+	{
+		std::puts(error);
 		return;
-	} catch(...) {
 	}
+
+	int fail_count = rids.size() - succ_count;
 	Protocol::OkPacket okPack;
     std::vector<uint8_t> outPut = okPack.Pack(succ_count, 0, 2, 0);
 	std::vector< uint8_t > res;
@@ -642,7 +1413,7 @@ void dbms::select_rows(const select_info_t *info, std::shared_ptr< SystemAbstrac
 	if(!assert_db_open())
 		return;
 
-	__cache_clear_guard __guard;
+	__cache_clear_guard __guard(cur_db);
 
 	// get required tables
 	std::vector<std::shared_ptr<table_manager>> alias_tables;
@@ -679,6 +1450,33 @@ void dbms::select_rows(const select_info_t *info, std::shared_ptr< SystemAbstrac
 		expr_names.push_back(expression::to_string(expr));
 	}
 
+	// scans read only the columns referenced by the query
+	__cached_columns_guard __cols_guard;
+	for(table_manager *tm : required_tables)
+	{
+		uint32_t cols = ~0u;
+		if(exprs.size() != 0)
+		{
+			cols = get_referenced_columns(tm, info->where);
+			for(expr_node_t *expr : exprs)
+				cols |= get_referenced_columns(tm, expr);
+		}
+
+		__cols_guard.set(tm, cols);
+	}
+
+	if(info->into)
+	{
+		if(is_aggregate)
+		{
+			std::fprintf(stderr, "[Error] cannot export aggregate queries.\n");
+			return;
+		}
+
+		export_rows(info, required_tables, exprs, expr_names, newConnection);
+		return;
+	}
+
 	std::vector<std::string> headers;
 	std::vector< std::vector<std::string> > rows;
 	// output header info
@@ -757,6 +1555,15 @@ void dbms::select_rows(const select_info_t *info, std::shared_ptr< SystemAbstrac
 		);
 	newConnection->SendMessage(outPack);
 
+	// columns referenced by the query, for index-only scans
+	uint32_t required_cols = ~0u;
+	if(required_tables.size() == 1 && exprs.size() != 0)
+	{
+		required_cols = get_column_mask(required_tables[0], info->where);
+		for(expr_node_t *expr : exprs)
+			required_cols |= get_column_mask(required_tables[0], expr);
+	}
+
 	if(is_aggregate)
 	{
 		select_rows_aggregate(
@@ -765,7 +1572,8 @@ void dbms::select_rows(const select_info_t *info, std::shared_ptr< SystemAbstrac
 			exprs,
 			expr_names,
 			newConnection,
-			seq
+			seq,
+			required_cols
 		);
 
 		return;
@@ -773,6 +1581,10 @@ void dbms::select_rows(const select_info_t *info, std::shared_ptr< SystemAbstrac
 
 	// iterate records
 	int counter = 0;
+	std::vector<compiled_expr> programs;
+	std::vector<const row_view*> cached_rows = get_rows(required_tables);
+	for(expr_node_t *expr : exprs)
+		programs.emplace_back(expr, cached_rows);
 
 	iterate(required_tables, info->where,
 		[&](const std::vector<table_manager*> &tables,
@@ -784,7 +1596,7 @@ void dbms::select_rows(const select_info_t *info, std::shared_ptr< SystemAbstrac
 			{
 				expression ret;
 				try {
-					ret = expression::eval(exprs[i]);
+					ret = programs[i].eval();
 				} catch (const char *e) {
 					std::fprintf(stderr, "%s\n", e);
 					printf("%s\n", e);
@@ -856,8 +1668,7 @@ void dbms::select_rows(const select_info_t *info, std::shared_ptr< SystemAbstrac
 			++counter;
 			
 			return true;
-		}
-	);
+		}, required_cols);
 
 	std::printf("[Info] %d row(s) selected.\n", counter);
 
@@ -903,13 +1714,146 @@ void dbms::select_rows(const select_info_t *info, std::shared_ptr< SystemAbstrac
 	std::fflush(output_file);
 }
 
+void dbms::export_rows(
+	const select_info_t *info,
+	const std::vector<table_manager*> &required_tables,
+	const std::vector<expr_node_t*> &exprs,
+	const std::vector<std::string> &expr_names,
+	std::shared_ptr< SystemAbstractions::NetworkConnection > newConnection)
+{
+	const export_info_t *into = info->into;
+	bool binary = false;
+	char delimiter = ',';
+	if(into->format)
+	{
+		if(strcasecmp(into->format, "tsv") == 0)
+		{
+			delimiter = '\t';
+		} else if(strcasecmp(into->format, "binary") == 0) {
+			binary = true;
+		} else if(strcasecmp(into->format, "csv") != 0) {
+			std::fprintf(stderr, "[Error] unknown export format `%s`.\n", into->format);
+			return;
+		}
+	} else if(into->delimiter) {
+		if(std::strcmp(into->delimiter, "\\t") == 0)
+		{
+			delimiter = '\t';
+		} else if(std::strlen(into->delimiter) == 1) {
+			delimiter = into->delimiter[0];
+		} else {
+			std::fprintf(stderr, "[Error] field delimiter must be a single character.\n");
+			return;
+		}
+	}
+
+	// columns are written in the order of the client rows, which is the
+	// reverse of the expressions and of the tables and their columns
+	std::vector<std::string> names;
+	if(exprs.size() == 0)
+	{
+		for(auto it = required_tables.rbegin(); it != required_tables.rend(); ++it)
+		{
+			for(int cid = (*it)->get_column_num() - 2; cid >= 0; --cid)
+				names.push_back((*it)->get_column_name(cid));
+		}
+	} else {
+		names.assign(expr_names.rbegin(), expr_names.rend());
+	}
+
+	result_exporter exporter(binary, delimiter);
+	if(!exporter.open(into->path, names))
+	{
+		std::fprintf(stderr, "[Error] cannot write file `%s`.\n", into->path);
+		return;
+	}
+
+	uint32_t required_cols = ~0u;
+	if(required_tables.size() == 1 && exprs.size() != 0)
+	{
+		required_cols = get_column_mask(required_tables[0], info->where);
+		for(expr_node_t *expr : exprs)
+			required_cols |= get_column_mask(required_tables[0], expr);
+	}
+
+	std::vector<compiled_expr> programs;
+	std::vector<const row_view*> rows = get_rows(required_tables);
+	for(expr_node_t *expr : exprs)
+		programs.emplace_back(expr, rows);
+
+	const char *error = nullptr;
+	iterate(required_tables, info->where,
+		[&](const std::vector<table_manager*> &tables,
+			const std::vector<record_manager*> &,
+			const std::vector<int>& )
+		{
+			for(auto it = programs.rbegin(); it != programs.rend(); ++it)
+			{
+				try {
+					exporter.append(it->eval());
+				} catch (const char *e) {
+					error = e;
+					return false;
+				}
+			}
+
+			for(size_t i = tables.size(); exprs.size() == 0 && i-- != 0; )
+			{
+				table_manager *tb = tables[i];
+				for(int cid = tb->get_column_num() - 2; cid >= 0; --cid)
+					exporter.append(tb->get_cached_expr(cid));
+			}
+
+			return true;
+		}, required_cols);
+
+	// no partial file is left, and the client is told
+	if(error)
+	{
+		exporter.abort();
+		std::fprintf(stderr, "%s\n", error);
+		Protocol::ErrPacket errPack;
+		std::vector<uint8_t> outPut = errPack.Pack(1105, "HY000", error);
+		std::vector< uint8_t > res;
+		res.push_back(outPut.size());
+		res.push_back(0);
+		res.push_back(0);
+		res.push_back(1);
+		res.insert(
+			res.end(),
+			outPut.begin(),
+			outPut.end()
+		);
+		newConnection->SendMessage(res);
+		return;
+	}
+
+	int counter = exporter.close();
+
+	Protocol::OkPacket okPack;
+	std::vector<uint8_t> outPut = okPack.Pack(counter, 0, 2, 0);
+	std::vector< uint8_t > res;
+	res.push_back(outPut.size());
+	res.push_back(0);
+	res.push_back(0);
+	res.push_back(1);
+	res.insert(
+		res.end(),
+		outPut.begin(),
+		outPut.end()
+	);
+	newConnection->SendMessage(res);
+	std::printf("[Info] %d row(s) exported.\n", counter);
+}
+
 void dbms::select_rows_aggregate(
 	const select_info_t *info,
 	const std::vector<table_manager*> &required_tables,
 	const std::vector<expr_node_t*> &exprs,
 	const std::vector<std::string> &, 
 	std::shared_ptr< SystemAbstractions::NetworkConnection > newConnection,
-	uint8_t seq_)
+	uint8_t seq_,
+	uint32_t required_cols)
 {
 	if(exprs.size() != 1)
 	{
@@ -934,7 +1878,13 @@ void dbms::select_rows_aggregate(
 	term_type_t agg_type = TERM_NONE;
 
 	int counter = 0;
-	iterate(required_tables, info->where,
+	compiled_expr operand;
+	if(expr->op != OPERATOR_COUNT)
+		operand = compiled_expr(expr->left, get_rows(required_tables));
+	// COUNT answered by index probes alone, without reading rows
+	bool counted = expr->op == OPERATOR_COUNT && required_tables.size() == 1
+		&& count_with_index(required_tables[0], info->where, &counter);
+	if(!counted) iterate(required_tables, info->where,
 		[&](const std::vector<table_manager*> &,
 			const std::vector<record_manager*> &,
 			const std::vector<int>& )
@@ -943,7 +1893,7 @@ void dbms::select_rows_aggregate(
 			{
 				expression ret;
 				try {
-					ret = expression::eval(expr->left);
+					ret = operand.eval();
 				} catch (const char *e) {
 					std::fprintf(stderr, "%s\n", e);
 					return false;
@@ -990,8 +1940,7 @@ void dbms::select_rows_aggregate(
 
 			++counter;
 			return true;
-		}
-	);
+		}, required_cols);
 
 	std::string result;
 
@@ -1067,7 +2016,7 @@ void dbms::delete_rows(const delete_info_t *info, std::shared_ptr< SystemAbstrac
 {
 	if(!assert_db_open())
 		return;
-	__cache_clear_guard __guard;
+	__cache_clear_guard __guard(cur_db);
 
 	std::vector<int> delete_list;
 	table_manager *tm = cur_db->get_table(info->table);
@@ -1077,15 +2026,16 @@ void dbms::delete_rows(const delete_info_t *info, std::shared_ptr< SystemAbstrac
 		return;
 	}
 
+	__cached_columns_guard __cols_guard;
+	__cols_guard.set(tm, get_referenced_columns(tm, info->where));
+
 	iterate_one_table_with_index(tm, info->where,
 		[&delete_list](table_manager*, record_manager*, int rid) -> bool {
 			delete_list.push_back(rid);
 			return true;
-		} );
+		}, get_column_mask(tm, info->where));
 
-	int counter = 0;
-	for(int rid : delete_list)
-		counter += tm->remove_record(rid);
+	int counter = tm->remove_records(delete_list);
 
 	std::printf("[Info] %d row(s) deleted.\n", counter);
 	Protocol::OkPacket okPack;
@@ -1107,7 +2057,7 @@ void dbms::insert_rows(const insert_info_t *info, std::shared_ptr< SystemAbstrac
 {
 	if(!assert_db_open())
 		return;
-	__cache_clear_guard __guard;
+	__cache_clear_guard __guard(cur_db);
 
 	table_manager *tb = cur_db->get_table(info->table);
 	if(tb == nullptr)
@@ -1137,7 +2087,9 @@ void dbms::insert_rows(const insert_info_t *info, std::shared_ptr< SystemAbstrac
 		}
 	}
 
+	// the rows are evaluated first, and then inserted in a batch
 	int count_succ = 0, count_fail = 0;
+	std::vector<std::string> records;
 	for(linked_list_t *list = info->values; list; list = list->next)
 	{
 		tb->init_temp_record();
@@ -1158,6 +2110,7 @@ void dbms::insert_rows(const insert_info_t *info, std::shared_ptr< SystemAbstrac
 				v = expression::eval((expr_node_t*)expr_list->data);
 			} catch (const char *e) {
 				std::fprintf(stderr, "%s\n", e);
+				tb->insert_records(records);
 				return;
 			}
 
@@ -1165,6 +2118,7 @@ void dbms::insert_rows(const insert_info_t *info, std::shared_ptr< SystemAbstrac
 			if(!typecast::type_compatible(col_type, v))
 			{
 				std::fprintf(stderr, "[Error] incompatible type.\n");
+				tb->insert_records(records);
 				return;
 			}
 
@@ -1172,16 +2126,20 @@ void dbms::insert_rows(const insert_info_t *info, std::shared_ptr< SystemAbstrac
 			char *db_val = typecast::expr_to_db(v, desired_type);
 			if(!tb->set_temp_record(*it, db_val))
 			{
+				std::fprintf(stderr, "[Error] string too long for column `%s'.\n",
+					tb->get_column_name(*it));
 				succ = false;
 				break;
 			}
 		}
 
-		if(succ) succ = (tb->insert_record() > 0);
-		count_succ += succ;
-		count_fail += 1 - succ;
+		if(succ) records.push_back(tb->get_temp_record());
+		else ++count_fail;
 	}
 
+	count_succ = tb->insert_records(records);
+	count_fail += records.size() - count_succ;
+
 	Protocol::OkPacket okPack;
     std::vector<uint8_t> outPut = okPack.Pack(count_succ, 0, 2, 0);
 	std::vector< uint8_t > res;
@@ -1198,20 +2156,140 @@ void dbms::insert_rows(const insert_info_t *info, std::shared_ptr< SystemAbstrac
 	std::printf("[Info] %d row(s) inserted, %d row(s) failed.\n", count_succ, count_fail);
 }
 
+void dbms::load_rows(const load_info_t *info, std::shared_ptr< SystemAbstractions::NetworkConnection > newConnection)
+{
+	if(!assert_db_open())
+		return;
+	__cache_clear_guard __guard(cur_db);
+
+	table_manager *tb = cur_db->get_table(info->table);
+	if(tb == nullptr)
+	{
+		std::fprintf(stderr, "[Error] table `%s` not found.\n", info->table);
+		return;
+	}
+
+	char delimiter = ',';
+	if(info->delimiter)
+	{
+		if(std::strcmp(info->delimiter, "\\t") == 0)
+		{
+			delimiter = '\t';
+		} else if(std::strlen(info->delimiter) == 1) {
+			delimiter = info->delimiter[0];
+		} else {
+			std::fprintf(stderr, "[Error] field delimiter must be a single character.\n");
+			return;
+		}
+	}
+
+	std::vector<int> cols_id;
+	if(info->columns == nullptr)
+	{
+		// exclude __rowid__, which has the largest index
+		for(int i = 0; i < tb->get_column_num() - 1; ++i)
+			cols_id.push_back(i);
+	} else {
+		for(linked_list_t *link_ptr = info->columns; link_ptr; link_ptr = link_ptr->next)
+		{
+			column_ref_t *column = (column_ref_t*)link_ptr->data;
+			int cid = tb->lookup_column(column->column);
+			if(cid < 0)
+			{
+				std::fprintf(stderr, "[Error] No column `%s` in table `%s`.\n",
+					column->column, tb->get_table_name());
+				return;
+			}
+			cols_id.push_back(cid);
+		}
+	}
+
+	// columns are in reversed order, while fields are in the order of the file
+	std::reverse(cols_id.begin(), cols_id.end());
+
+	int count_succ, count_fail;
+	bulk_loader loader(tb, cols_id, delimiter);
+	if(!loader.load(info->path, &count_succ, &count_fail))
+	{
+		std::fprintf(stderr, "[Error] cannot read file `%s`.\n", info->path);
+		return;
+	}
+
+	Protocol::OkPacket okPack;
+	std::vector<uint8_t> outPut = okPack.Pack(count_succ, 0, 2, 0);
+	std::vector< uint8_t > res;
+	res.push_back(outPut.size());
+	res.push_back(0);
+	res.push_back(0);
+	res.push_back(1);
+	res.insert(
+		res.end(),
+		outPut.begin(),
+		outPut.end()
+	);
+	newConnection->SendMessage(res);
+	std::printf("[Info] %d row(s) loaded, %d row(s) failed.\n", count_succ, count_fail);
+}
+
 void dbms::drop_index(const char *tb_name, const char *col_name, std::shared_ptr< SystemAbstractions::NetworkConnection > newConnection)
 {
 }
 
-void dbms::create_index(const char *tb_name, const char *col_name, std::shared_ptr< SystemAbstractions::NetworkConnection > newConnection)
+void dbms::create_index(const index_info_t *info, std::shared_ptr< SystemAbstractions::NetworkConnection > newConnection)
 {
 	if(!assert_db_open())
 		return;
-	table_manager *tb = cur_db->get_table(tb_name);
+	table_manager *tb = cur_db->get_table(info->table);
 	if(tb == nullptr)
 	{
-		std::fprintf(stderr, "[Error] table `%s` not exists.\n", tb_name);
+		std::fprintf(stderr, "[Error] table `%s` not exists.\n", info->table);
 	} else {
-		tb->create_index(col_name);
+		uint32_t include = 0;
+		std::vector<int> cols;
+		bool ok = true;
+		for(linked_list_t *link_p = info->includes; ok && link_p; link_p = link_p->next)
+		{
+			column_ref_t *col = (column_ref_t*)link_p->data;
+			int cid = tb->lookup_column(col->column);
+			if(cid < 0)
+			{
+				std::fprintf(stderr, "[Error] column `%s' not exists.\n", col->column);
+				ok = false;
+			} else include |= 1u << cid;
+		}
+
+		for(linked_list_t *link_p = info->columns; ok && link_p; link_p = link_p->next)
+		{
+			column_ref_t *col = (column_ref_t*)link_p->data;
+			int cid = tb->lookup_column(col->column);
+			if(cid < 0)
+			{
+				std::fprintf(stderr, "[Error] column `%s' not exists.\n", col->column);
+				ok = false;
+			} else cols.push_back(cid);
+		}
+
+		// column list is in reversed order
+		std::reverse(cols.begin(), cols.end());
+		if(ok && info->type == INDEX_TYPE_BITMAP)
+		{
+			if(cols.size() != 1)
+				std::fprintf(stderr, "[Error] BITMAP is not supported for composite index.\n");
+			else tb->create_bitmap_index(tb->get_column_name(cols[0]));
+		} else if(ok && info->type == INDEX_TYPE_TRIGRAM) {
+			if(cols.size() != 1 || include)
+				std::fprintf(stderr, "[Error] TRIGRAM index is on a single column without INCLUDE.\n");
+			else tb->create_trigram_index(tb->get_column_name(cols[0]));
+		} else if(ok && cols.size() == 1) {
+			tb->create_index(tb->get_column_name(cols[0]), include,
+				info->type == INDEX_TYPE_HASH);
+		} else if(ok) {
+			if(include)
+				std::fprintf(stderr, "[Error] INCLUDE is not supported for composite index.\n");
+			else if(info->type == INDEX_TYPE_HASH)
+				std::fprintf(stderr, "[Error] HASH is not supported for composite index.\n");
+			else tb->create_composite_index(cols);
+		}
 	}
 	Protocol::OkPacket okPack;
     std::vector<uint8_t> outPut = okPack.Pack(0, 0, 2, 0);
@@ -4,11 +4,14 @@
 #include "../table/table.h"
 #include "../parser/defs.h"
 #include "../expression/expression.h"
+#include "../expression/compiled_expr.h"
+#include "../index/rid_bitmap.h"
 #include <cstdio>
 #include <SystemPort/NetworkEndpoint.hpp>
 #include <protocol/Ok.hpp>
 #include <protocol/Field.hpp>
 #include <protocol/Eof.hpp>
+#include <protocol/Err.hpp>
 class dbms
 {
 	FILE *output_file;
@@ -29,10 +32,11 @@ public:
 	void show_table(const char *table_name);
 	void drop_table(const char *table_name, std::shared_ptr< SystemAbstractions::NetworkConnection > newConnection);
 
-	void create_index(const char *tb_name, const char *col_name, std::shared_ptr< SystemAbstractions::NetworkConnection > newConnection);
+	void create_index(const index_info_t *info, std::shared_ptr< SystemAbstractions::NetworkConnection > newConnection);
 	void drop_index(const char *tb_name, const char *col_name, std::shared_ptr< SystemAbstractions::NetworkConnection > newConnection);
 
 	void insert_rows(const insert_info_t *info, std::shared_ptr< SystemAbstractions::NetworkConnection > newConnection);
+	void load_rows(const load_info_t *info, std::shared_ptr< SystemAbstractions::NetworkConnection > newConnection);
 	void delete_rows(const delete_info_t *info, std::shared_ptr< SystemAbstractions::NetworkConnection > newConnection);
 	void select_rows(const select_info_t *info, std::shared_ptr< SystemAbstractions::NetworkConnection > newConnection);
 	void update_rows(const update_info_t *info, std::shared_ptr< SystemAbstractions::NetworkConnection > newConnection);
@@ -45,7 +49,15 @@ public:
 		const std::vector<expr_node_t*> &exprs,
 		const std::vector<std::string> &expr_names, 
 		std::shared_ptr< SystemAbstractions::NetworkConnection > newConnection, 
-		uint8_t seq_);
+		uint8_t seq_,
+		uint32_t required_cols = ~0u);
+
+	void export_rows(
+		const select_info_t *info,
+		const std::vector<table_manager*> &required_tables,
+		const std::vector<expr_node_t*> &exprs,
+		const std::vector<std::string> &expr_names,
+		std::shared_ptr< SystemAbstractions::NetworkConnection > newConnection);
 
 	bool value_exists(const char *table, const char *column, const char *data);
 
@@ -54,29 +66,69 @@ public:
 	void cache_record(table_manager *tm, record_manager *rm);
 
 	template<typename Callback>
-	void iterate(std::vector<table_manager*> required_tables, expr_node_t *cond, Callback callback);
+	void iterate(std::vector<table_manager*> required_tables, expr_node_t *cond,
+			Callback callback, uint32_t required_cols = ~0u);
 
 	template<typename Callback>
 	void iterate_one_table(table_manager* table,
 			expr_node_t *cond, Callback callback);
+	// rows found by an index are fetched in batches sorted by rowid
 	template<typename Callback>
 	bool iterate_one_table_with_index(table_manager* table,
-			expr_node_t *cond, Callback callback);
+			expr_node_t *cond, Callback callback, uint32_t required_cols = ~0u);
+	template<typename Callback>
+	bool iterate_one_table_with_composite_index(table_manager* table,
+			expr_node_t *cond, const std::vector<expr_node_t*> &and_cond,
+			int min_score, Callback callback);
+	// AND/OR of rid sets from several indexes
+	template<typename Callback>
+	bool iterate_one_table_with_bitmap(table_manager* table,
+			expr_node_t *cond, const std::vector<expr_node_t*> &and_cond,
+			Callback callback);
+	template<typename Callback>
+	bool fetch_records(table_manager *table, std::vector<int> &rids,
+			Callback callback);
 	template<typename Callback>
 	bool iterate_many_tables_impl(
 		const std::vector<table_manager*> &table_list,
 		std::vector<record_manager*> &record_list,
 		std::vector<int> &rid_list,
-		std::vector<std::vector<expr_node_t*>> &index_cond,
+		const std::vector<std::vector<compiled_expr>> &join_conds,
 		int *iter_order, int *index_cid, index_manager** index,
-		expr_node_t *cond, Callback callback, int now);
+		const compiled_expr &cond, Callback callback, int now);
 	template<typename Callback>
 	void iterate_many_tables(
 		const std::vector<table_manager*> &table_list,
 		expr_node_t *cond, Callback callback);
 
 	static expr_node_t *get_join_cond(expr_node_t *cond);
+	static uint32_t get_column_mask(table_manager *table, const expr_node_t *expr);
+	// columns of `table' referenced by `expr', other columns are ignored
+	static uint32_t get_referenced_columns(table_manager *table, const expr_node_t *expr);
+	static char *get_index_key(expr_node_t *val);
+	// indexed column of `column = literal' or `column IN (literals)', or -1
+	static int get_probe_column(table_manager *table, expr_node_t *expr);
+	/* Collect the rids matching `expr', which is made of the above, LIKE
+	 * on columns with trigram index (a superset of the matching rids) and
+	 * OR of them, or only check whether it is possible if `rids' is nullptr */
+	static bool probe_index(table_manager *table, expr_node_t *expr, rid_bitmap *rids);
+	static void probe_index_and(table_manager *table,
+			const std::vector<expr_node_t*> &and_cond, rid_bitmap &result);
+	static bool count_with_index(table_manager *table, expr_node_t *cond, int *count);
 	static void extract_and_cond(expr_node_t *cond, std::vector<expr_node_t*> &and_cond);
+	// conjuncts `column op literal' on columns with zone maps
+	static void get_zone_conds(table_manager *table, expr_node_t *cond,
+			std::vector<zone_map::cond_t> &conds);
+	// a conjunct on a column with dictionary, evaluated for each code
+	struct dict_cond_t
+	{
+		int cid;
+		std::vector<char> match;
+	};
+	/* conjuncts `column op literal' (=, <>, LIKE, IN) on columns with
+	 * dictionaries, return true if they are all the conjuncts */
+	static bool get_dict_conds(table_manager *table, expr_node_t *cond,
+			std::vector<dict_cond_t> &conds);
 	static bool find_longest_path(int now, int depth, int *mark, int *path, std::vector<std::vector<int>> &E, int excepted_len, int &max_depth);
 
 public:
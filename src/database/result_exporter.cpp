@@ -0,0 +1,424 @@
+#include "result_exporter.h"
+#include "../defs.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+
+namespace {
+
+// the formatted dates, cached by day
+struct date_cache_t
+{
+	static const int size = 256;
+	int key[size];
+	char str[size][16];
+	int len[size];
+	bool valid[size];
+
+	date_cache_t() { std::fill(valid, valid + size, false); }
+
+	const char *get(int val, int *length)
+	{
+		int slot = (unsigned)val / 86400 % size;
+		if(!valid[slot] || key[slot] != val)
+		{
+			std::tm tm;
+			time_t time = val;
+			localtime_r(&time, &tm);
+			len[slot] = std::strftime(str[slot], sizeof(str[slot]), DATE_TEMPLATE, &tm);
+			key[slot] = val;
+			valid[slot] = true;
+		}
+
+		*length = len[slot];
+		return str[slot];
+	}
+};
+
+int format_int(char *buf, int val)
+{
+	char tmp[16];
+	int n = 0;
+	uint32_t v = val < 0 ? 0u - (uint32_t)val : (uint32_t)val;
+	do {
+		tmp[n++] = '0' + v % 10;
+		v /= 10;
+	} while(v);
+
+	int len = 0;
+	if(val < 0) buf[len++] = '-';
+	while(n) buf[len++] = tmp[--n];
+	return len;
+}
+
+/* The same as printf("%f"). A float times 1e6 is exact in a double
+ * (24 + 14 bits), so rounding it half to even matches printf. */
+int format_float(char *buf, float val)
+{
+	double d = val;
+	if(!(std::fabs(d) < 1e12))
+		return std::snprintf(buf, 64, "%f", d);
+
+	uint64_t scaled = (uint64_t)std::nearbyint(std::fabs(d) * 1e6);
+	int len = 0;
+	if(std::signbit(d)) buf[len++] = '-';
+	char tmp[24];
+	int n = 0;
+	uint64_t int_part = scaled / 1000000;
+	do {
+		tmp[n++] = '0' + int_part % 10;
+		int_part /= 10;
+	} while(int_part);
+	while(n) buf[len++] = tmp[--n];
+
+	buf[len++] = '.';
+	uint32_t frac = scaled % 1000000;
+	for(int i = 5; i >= 0; --i, frac /= 10)
+		buf[len + i] = '0' + frac % 10;
+	return len + 6;
+}
+
+// plain text of a non-NULL value
+void value_text(int type, uint32_t bits, const char *str, std::string &out, date_cache_t &dates)
+{
+	char buf[64];
+	int len;
+	switch(type)
+	{
+		case result_exporter::TYPE_INT:
+			out.append(buf, format_int(buf, (int)bits));
+			break;
+		case result_exporter::TYPE_FLOAT: {
+			float f;
+			std::memcpy(&f, &bits, 4);
+			out.append(buf, format_float(buf, f));
+			break; }
+		case result_exporter::TYPE_DATE: {
+			const char *date = dates.get((int)bits, &len);
+			out.append(date, len);
+			break; }
+		case result_exporter::TYPE_BOOL:
+			out.append(bits ? "TRUE" : "FALSE");
+			break;
+		case result_exporter::TYPE_STRING:
+			out.append(str);
+			break;
+	}
+}
+
+template<typename T>
+void put(std::string &out, T val)
+{
+	out.append(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+}
+
+result_exporter::result_exporter(bool is_binary, char delim)
+	: file(nullptr), binary(is_binary), delimiter(delim),
+	  col_num(0), cur_col(0), row_count(0), cur(nullptr), closing(false)
+{
+}
+
+result_exporter::~result_exporter()
+{
+	if(file) close();
+	delete cur;
+}
+
+bool result_exporter::open(const char *filename, const std::vector<std::string> &names)
+{
+	file = std::fopen(filename, "wb");
+	if(!file) return false;
+	path = filename;
+
+	col_num = names.size();
+	cur = new batch_t { 0, std::vector<column_t>(col_num), std::string(), false };
+	if(binary)
+	{
+		std::string head("TDBCOL1", 8);
+		put<uint32_t>(head, col_num);
+		for(const std::string &name : names)
+		{
+			put<uint16_t>(head, name.size());
+			head += name;
+		}
+
+		std::fwrite(head.data(), 1, head.size(), file);
+	}
+
+	int threads = std::thread::hardware_concurrency();
+	threads = std::max(1, std::min(threads, EXPORT_MAX_THREADS));
+	for(int i = 0; i != threads; ++i)
+		workers.emplace_back(&result_exporter::work, this);
+	writer = std::thread(&result_exporter::write, this);
+	return true;
+}
+
+void result_exporter::push(int type, uint32_t bits)
+{
+	column_t &col = cur->cols[cur_col];
+	col.types.push_back(type);
+	col.values.push_back(bits);
+	if(++cur_col == col_num)
+	{
+		cur_col = 0;
+		++row_count;
+		if(++cur->rows == EXPORT_BATCH_ROWS)
+			submit();
+	}
+}
+
+void result_exporter::append(const expression &val)
+{
+	switch(val.type)
+	{
+		case TERM_INT:    append_int(val.val_i); break;
+		case TERM_FLOAT:  append_float(val.val_f); break;
+		case TERM_DATE:   append_date(val.val_i); break;
+		case TERM_STRING: append_string(val.val_s); break;
+		case TERM_BOOL:   push(TYPE_BOOL, val.val_b); break;
+		default:          append_null(); break;
+	}
+}
+
+void result_exporter::append_null()
+{
+	push(TYPE_NULL, 0);
+}
+
+void result_exporter::append_int(int val)
+{
+	push(TYPE_INT, (uint32_t)val);
+}
+
+void result_exporter::append_float(float val)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &val, 4);
+	push(TYPE_FLOAT, bits);
+}
+
+void result_exporter::append_date(int val)
+{
+	push(TYPE_DATE, (uint32_t)val);
+}
+
+void result_exporter::append_string(const char *val)
+{
+	std::string &strings = cur->cols[cur_col].strings;
+	uint32_t offset = strings.size();
+	strings.append(val, std::strlen(val) + 1);
+	push(TYPE_STRING, offset);
+}
+
+void result_exporter::submit()
+{
+	if(cur->rows == 0) return;
+	std::unique_lock<std::mutex> lock(mtx);
+	// bound the batches in memory
+	size_t max_batches = workers.size() * 2 + 2;
+	cond.wait(lock, [&] { return in_order.size() < max_batches; });
+	in_order.push_back(cur);
+	to_format.push_back(cur);
+	cond.notify_all();
+	lock.unlock();
+
+	cur = new batch_t { 0, std::vector<column_t>(col_num), std::string(), false };
+}
+
+void result_exporter::work()
+{
+	for(;;)
+	{
+		std::unique_lock<std::mutex> lock(mtx);
+		cond.wait(lock, [&] { return !to_format.empty() || closing; });
+		if(to_format.empty()) return;
+		batch_t *batch = to_format.front();
+		to_format.pop_front();
+		lock.unlock();
+
+		if(binary) format_binary(batch);
+		else format_text(batch);
+
+		lock.lock();
+		batch->ready = true;
+		cond.notify_all();
+	}
+}
+
+void result_exporter::write()
+{
+	for(;;)
+	{
+		std::unique_lock<std::mutex> lock(mtx);
+		cond.wait(lock, [&] {
+			return (!in_order.empty() && in_order.front()->ready)
+				|| (closing && in_order.empty());
+		} );
+
+		if(in_order.empty()) return;
+		batch_t *batch = in_order.front();
+		in_order.pop_front();
+		cond.notify_all();
+		lock.unlock();
+
+		std::fwrite(batch->out.data(), 1, batch->out.size(), file);
+		delete batch;
+	}
+}
+
+void result_exporter::format_text(batch_t *batch)
+{
+	date_cache_t dates;
+	std::string &out = batch->out;
+	out.reserve(batch->rows * col_num * 8);
+	for(int r = 0; r != batch->rows; ++r)
+	{
+		for(int c = 0; c != col_num; ++c)
+		{
+			if(c) out.push_back(delimiter);
+			const column_t &col = batch->cols[c];
+			int type = col.types[r];
+			if(type == TYPE_NULL)
+			{
+				out.append("\\N");
+			} else if(type == TYPE_STRING) {
+				// quote the strings which would be read back differently
+				const char *str = col.strings.data() + col.values[r];
+				bool quote = !*str || std::strcmp(str, "\\N") == 0 || *str == '"';
+				for(const char *p = str; !quote && *p; ++p)
+					quote = *p == delimiter || *p == '\n' || *p == '\r';
+				if(!quote)
+				{
+					out.append(str);
+				} else {
+					out.push_back('"');
+					for(const char *p = str; *p; ++p)
+					{
+						if(*p == '"') out.push_back('"');
+						out.push_back(*p);
+					}
+					out.push_back('"');
+				}
+			} else {
+				value_text(type, col.values[r], nullptr, out, dates);
+			}
+		}
+
+		out.push_back('\n');
+	}
+}
+
+int result_exporter::column_type(const column_t &col, int rows)
+{
+	int type = TYPE_NULL;
+	for(int r = 0; r != rows; ++r)
+	{
+		int t = col.types[r];
+		if(t == TYPE_NULL || t == type) continue;
+		if(type == TYPE_NULL)
+			type = t;
+		else if((type == TYPE_INT && t == TYPE_FLOAT) || (type == TYPE_FLOAT && t == TYPE_INT))
+			type = TYPE_FLOAT;
+		else return TYPE_STRING;
+	}
+
+	return type;
+}
+
+void result_exporter::format_binary(batch_t *batch)
+{
+	date_cache_t dates;
+	std::string &out = batch->out;
+	put<uint32_t>(out, batch->rows);
+	for(const column_t &col : batch->cols)
+	{
+		int type = column_type(col, batch->rows);
+		put<uint8_t>(out, type);
+
+		std::string nulls((batch->rows + 7) / 8, 0);
+		for(int r = 0; r != batch->rows; ++r)
+		{
+			if(col.types[r] == TYPE_NULL)
+				nulls[r >> 3] |= 1 << (r & 7);
+		}
+		out += nulls;
+
+		if(type == TYPE_STRING)
+		{
+			std::string bytes;
+			for(int r = 0; r != batch->rows; ++r)
+			{
+				int t = col.types[r];
+				if(t != TYPE_NULL)
+				{
+					const char *str = t == TYPE_STRING ? col.strings.data() + col.values[r] : nullptr;
+					value_text(t, col.values[r], str, bytes, dates);
+				}
+				put<uint32_t>(out, bytes.size());
+			}
+			out += bytes;
+		} else if(type != TYPE_NULL) {
+			for(int r = 0; r != batch->rows; ++r)
+			{
+				uint32_t bits = col.values[r];
+				if(col.types[r] == TYPE_NULL)
+				{
+					bits = 0;
+				} else if(type == TYPE_FLOAT && col.types[r] == TYPE_INT) {
+					float f = (int)bits;
+					std::memcpy(&bits, &f, 4);
+				}
+				put<uint32_t>(out, bits);
+			}
+		}
+	}
+}
+
+int result_exporter::close()
+{
+	if(!file) return row_count;
+	submit();
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		closing = true;
+		cond.notify_all();
+	}
+
+	for(std::thread &t : workers)
+		t.join();
+	writer.join();
+	workers.clear();
+
+	if(binary)
+	{
+		uint32_t end = 0;
+		std::fwrite(&end, 4, 1, file);
+	}
+
+	std::fclose(file);
+	file = nullptr;
+	return row_count;
+}
+
+void result_exporter::abort()
+{
+	if(!file) return;
+	// the batches already submitted are written, then the file is removed
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		closing = true;
+		cond.notify_all();
+	}
+
+	for(std::thread &t : workers)
+		t.join();
+	writer.join();
+	workers.clear();
+
+	std::fclose(file);
+	file = nullptr;
+	std::remove(path.c_str());
+}
@@ -0,0 +1,93 @@
+#ifndef __TRIVIALDB_RESULT_EXPORTER__
+#define __TRIVIALDB_RESULT_EXPORTER__
+#include <condition_variable>
+#include <cstdio>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../expression/expression.h"
+
+/* Writer of query results to a file (SELECT ... INTO OUTFILE).
+ * The scanning thread appends the values of each row into a batch, which
+ * keeps them by column. Full batches are formatted by worker threads and
+ * written in order by a writer thread, so the scan is not held up by
+ * formatting or by the file.
+ *
+ * Text format: one row per line, fields separated by the delimiter, NULL
+ * written as `\N`, and strings quoted with `""` for `"` when needed, so
+ * that the file can be read back by LOAD DATA INFILE.
+ *
+ * Binary format, little-endian:
+ *   file   | "TDBCOL1\0" | u32 column number | (u16 length, name) ... | block ... | u32 0 |
+ *   block  | u32 row number | column ... |
+ *   column | u8 type | null bitmap, 1 bit per row | values |
+ * The values are 4 bytes per row for int, float, date (seconds since the
+ * epoch) and bool, or u32 end offsets per row and then the bytes for
+ * strings. Type 0 means the column has only NULLs in the block. */
+
+class result_exporter
+{
+public:
+	enum type_t { TYPE_NULL = 0, TYPE_INT, TYPE_FLOAT, TYPE_DATE, TYPE_STRING, TYPE_BOOL };
+
+private:
+	struct column_t
+	{
+		std::vector<uint8_t> types;
+		std::vector<uint32_t> values;  // value bits, or offset of strings
+		std::string strings;
+	};
+
+	struct batch_t
+	{
+		int rows;
+		std::vector<column_t> cols;
+		std::string out;
+		bool ready;
+	};
+
+	FILE *file;
+	std::string path;
+	bool binary;
+	char delimiter;
+	int col_num, cur_col, row_count;
+	batch_t *cur;
+
+	std::mutex mtx;
+	std::condition_variable cond;
+	std::deque<batch_t*> in_order, to_format;
+	std::vector<std::thread> workers;
+	std::thread writer;
+	bool closing;
+
+	void submit();
+	void work();
+	void write();
+	void format_text(batch_t *batch);
+	void format_binary(batch_t *batch);
+	int column_type(const column_t &col, int rows);
+	void push(int type, uint32_t bits);
+
+public:
+	// delimiter is ignored for the binary format
+	result_exporter(bool binary, char delimiter);
+	~result_exporter();
+
+	bool open(const char *path, const std::vector<std::string> &names);
+	// values of a row are appended in column order
+	void append(const expression &val);
+	void append_null();
+	void append_int(int val);
+	void append_float(float val);
+	void append_date(int val);
+	void append_string(const char *val);
+	// finish the file, return the number of rows written
+	int close();
+	// stop writing and remove the file
+	void abort();
+};
+
+#endif
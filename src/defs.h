@@ -5,6 +5,10 @@
 #define PAGE_SIZE 4096
 #define PAGE_CACHE_CAPACITY 8192
 #define MAX_FILE_ID 1024
+// bumped when the layout of pages changes (2: overflow pages with runs)
+#define PAGE_FS_VERSION 2
+// free pages looked through for a run of consecutive ones
+#define FREE_RUN_SEARCH_MAX 1024
 
 /* database info */
 #define MAX_TABLE_NUM   32
@@ -22,6 +26,43 @@
 #define PAGE_INDEX_LEAF 0x4947
 #define PAGE_VARIANT    0x4156
 #define PAGE_OVERFLOW   0x564f
+#define PAGE_HASH_DIR    0x4844
+#define PAGE_HASH_BUCKET 0x4842
+#define PAGE_BLOOM       0x4642
+
+/* hash index */
+#define HASH_MAX_GLOBAL_DEPTH  9
+#define HASH_DIR_MAX_SIZE      (1 << HASH_MAX_GLOBAL_DEPTH)
+
+/* adaptive index of hot b-tree leaves */
+#define AHI_HOT_LOOKUPS        8
+#define AHI_MAX_PAGES          1024
+
+/* skip scan of composite index, if its leading column has no more
+ * distinct values than this */
+#define SKIP_SCAN_MAX_GROUPS   64
+
+/* column segments of data leaves scanned this many times with conditions,
+ * see table/column_cache.h; a size of 0 disables the cache */
+#define COLUMN_CACHE_HOT_SCANS 2
+#define COLUMN_CACHE_MAX_PAGES 4096
+
+/* rows fetched at once in rowid order when scanning an index */
+#define MRR_BATCH_SIZE         1024
+
+/* LOAD DATA INFILE: bytes parsed by each worker thread at a time */
+#define LOAD_CHUNK_SIZE        (4 << 20)
+#define LOAD_MAX_THREADS       16
+
+/* SELECT ... INTO OUTFILE: rows formatted by a worker thread at a time */
+#define EXPORT_BATCH_ROWS      8192
+#define EXPORT_MAX_THREADS     8
+
+/* bloom filter of index */
+#define BLOOM_BITS_PER_KEY     10
+#define BLOOM_HASH_NUM         6
+#define BLOOM_BLOCK_BITS       512
+#define BLOOM_MAX_PAGES        ((PAGE_SIZE - 16) / 4)
 
 /* table info */
 #define MAX_COL_NUM     32
@@ -29,6 +70,10 @@
 #define MAX_DEFAULT_LEN   256
 #define MAX_CHECK_CONSTRAINT_NUM  16
 #define MAX_CHECK_CONSTRAINT_LEN  1024
+#define MAX_COMPOSITE_INDEX_NUM   8
+#define MAX_COMPOSITE_INDEX_COL   8
+// total length of the VARCHAR columns of a table
+#define MAX_VARCHAR_SIZE  65535
 
 #define COL_FLAG_PRIMARY   1
 #define COL_FLAG_INDEX     2
@@ -0,0 +1,582 @@
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <strings.h>
+#include "compiled_expr.h"
+#include "../defs.h"
+#include "../utils/comparer.h"
+#include "../table/row_view.h"
+
+#define ERROR_UNSUPPORTED_OPERATOR "[Error] unsupported operator."
+#define ERROR_COLUMN_NOT_CACHED    "[Error] column not cached."
+#define ERROR_COLUMN_NOT_UNIQUE    "[Error] column not unique."
+#define ERROR_TYPE_INCOMPATIBLE    "[Error] operand type incompatible."
+#define ERROR_TYPE_MISMATCH        "[Error] operand type mismatch."
+#define ERROR_UNKNOWN_TYPE         "[Error] unknown type."
+
+namespace {
+
+enum opcode_t
+{
+	OP_NOP,
+	OP_CONST, OP_CONST_NULL,
+	// raised always, or unless an operand is NULL, which gives NULL
+	OP_THROW, OP_ERROR,
+	// INT and DATE columns are loaded by OP_LOAD_I
+	OP_LOAD_I, OP_LOAD_F, OP_LOAD_S,
+	OP_ADD_I, OP_SUB_I, OP_MUL_I, OP_DIV_I, OP_NEG_I,
+	OP_ADD_F, OP_SUB_F, OP_MUL_F, OP_DIV_F, OP_NEG_F,
+	OP_EQ_I, OP_NE_I, OP_LT_I, OP_LE_I, OP_GT_I, OP_GE_I,
+	OP_EQ_F, OP_NE_F, OP_LT_F, OP_LE_F, OP_GT_F, OP_GE_F,
+	OP_EQ_B, OP_NE_B, OP_AND_B, OP_OR_B,
+	OP_EQ_S, OP_NE_S, OP_LIKE_S,
+	OP_ISNULL, OP_NOTNULL,
+	OP_IN_I, OP_IN_F, OP_IN_S,
+	// FALSE to register b, skipping the instructions up to it, if register
+	// a is not TRUE; the conjunctions of conditions are short-circuited
+	OP_JUMP_FALSE
+};
+
+bool is_constant(const expr_node_t *expr)
+{
+	if(expr->op == OPERATOR_NONE)
+		return expr->term_type != TERM_COLUMN_REF;
+	if(!is_constant(expr->left))
+		return false;
+	return (expr->op & OPERATOR_UNARY) || is_constant(expr->right);
+}
+
+// the opcode of `op' on operands of type `type', or OP_NOP if unsupported
+int binary_opcode(operator_type_t op, term_type_t type, term_type_t *result)
+{
+	*result = TERM_BOOL;
+	switch(type)
+	{
+		case TERM_INT:
+		case TERM_FLOAT: {
+			bool is_int = type == TERM_INT;
+			switch(op)
+			{
+				case OPERATOR_ADD:   *result = type; return is_int ? OP_ADD_I : OP_ADD_F;
+				case OPERATOR_MINUS: *result = type; return is_int ? OP_SUB_I : OP_SUB_F;
+				case OPERATOR_MUL:   *result = type; return is_int ? OP_MUL_I : OP_MUL_F;
+				case OPERATOR_DIV:   *result = type; return is_int ? OP_DIV_I : OP_DIV_F;
+				case OPERATOR_EQ:  return is_int ? OP_EQ_I : OP_EQ_F;
+				case OPERATOR_NEQ: return is_int ? OP_NE_I : OP_NE_F;
+				case OPERATOR_LT:  return is_int ? OP_LT_I : OP_LT_F;
+				case OPERATOR_LEQ: return is_int ? OP_LE_I : OP_LE_F;
+				case OPERATOR_GT:  return is_int ? OP_GT_I : OP_GT_F;
+				case OPERATOR_GEQ: return is_int ? OP_GE_I : OP_GE_F;
+				default: return OP_NOP;
+			}
+		}
+		case TERM_DATE:
+			switch(op)
+			{
+				case OPERATOR_EQ:  return OP_EQ_I;
+				case OPERATOR_NEQ: return OP_NE_I;
+				case OPERATOR_LT:  return OP_LT_I;
+				case OPERATOR_LEQ: return OP_LE_I;
+				case OPERATOR_GT:  return OP_GT_I;
+				case OPERATOR_GEQ: return OP_GE_I;
+				default: return OP_NOP;
+			}
+		case TERM_BOOL:
+			switch(op)
+			{
+				case OPERATOR_AND: return OP_AND_B;
+				case OPERATOR_OR:  return OP_OR_B;
+				case OPERATOR_EQ:  return OP_EQ_B;
+				case OPERATOR_NEQ: return OP_NE_B;
+				default: return OP_NOP;
+			}
+		case TERM_STRING:
+			switch(op)
+			{
+				case OPERATOR_EQ:   return OP_EQ_S;
+				case OPERATOR_NEQ:  return OP_NE_S;
+				case OPERATOR_LIKE: return OP_LIKE_S;
+				default: return OP_NOP;
+			}
+		default:
+			return OP_NOP;
+	}
+}
+
+bool less_str(const char *a, const char *b)
+{
+	return std::strcmp(a, b) < 0;
+}
+
+}
+
+compiled_expr::compiled_expr(const expr_node_t *expr,
+		const std::vector<const row_view*> &rows, bool is_cond)
+	: rows(rows)
+{
+	if(expr) compile(expr, is_cond);
+	regs.resize(prog.size());
+}
+
+compiled_expr::compiled_expr(const expr_node_t *expr, const row_view *row, bool is_cond)
+	: compiled_expr(expr, std::vector<const row_view*>(1, row), is_cond)
+{
+}
+
+int compiled_expr::emit(int op, term_type_t type, int a, int b)
+{
+	int id = prog.size();
+	instr_t in;
+	in.op = op;
+	// unary instructions have the same operands
+	in.a = a < 0 ? id : a;
+	in.b = b < 0 ? in.a : b;
+	in.val.i = 0;
+	in.cid = 0;
+	prog.push_back(in);
+	types.push_back(type);
+	return id;
+}
+
+int compiled_expr::emit_const(const expression &val)
+{
+	int id;
+	switch(val.type)
+	{
+		case TERM_INT:
+		case TERM_DATE:
+			id = emit(OP_CONST, val.type);
+			prog[id].val.i = val.val_i;
+			return id;
+		case TERM_FLOAT:
+			id = emit(OP_CONST, val.type);
+			prog[id].val.f = val.val_f;
+			return id;
+		case TERM_BOOL:
+			id = emit(OP_CONST, val.type);
+			prog[id].val.b = val.val_b;
+			return id;
+		case TERM_STRING:
+			id = emit(OP_CONST, val.type);
+			prog[id].val.s = val.val_s;
+			return id;
+		case TERM_NULL:
+			return emit(OP_CONST_NULL, TERM_NULL);
+		default:
+			return emit_error(ERROR_UNKNOWN_TYPE);
+	}
+}
+
+int compiled_expr::emit_error(const char *msg, int a, int b)
+{
+	int id = emit(a < 0 ? OP_THROW : OP_ERROR, TERM_NULL, a, b < 0 ? a : b);
+	prog[id].error = msg;
+	return id;
+}
+
+bool compiled_expr::has_error(int begin, int end) const
+{
+	for(int i = begin; i != end; ++i)
+	{
+		int op = prog[i].op;
+		if(op == OP_THROW || op == OP_ERROR)
+			return true;
+		if((op == OP_IN_I || op == OP_IN_F || op == OP_IN_S)
+				&& !lists[prog[i].list].errors.empty())
+			return true;
+	}
+
+	return false;
+}
+
+int compiled_expr::compile(const expr_node_t *expr, bool as_cond)
+{
+	assert(expr != nullptr);
+	if(expr->op == OPERATOR_NONE && expr->term_type == TERM_COLUMN_REF)
+		return compile_column(expr);
+
+	if(expr->op == OPERATOR_NONE && expr->term_type == TERM_LITERAL_LIST)
+		return emit_error(ERROR_UNKNOWN_TYPE);
+
+	if(is_constant(expr))
+	{
+		try {
+			return emit_const(expression::eval(expr));
+		} catch(const char *msg) {
+			return emit_error(msg);
+		}
+	}
+
+	assert(expr->term_type == TERM_NONE);
+	if(expr->op & OPERATOR_UNARY)
+		return compile_unary(expr->op, compile(expr->left, false));
+
+	int left = compile(expr->left, as_cond && expr->op == OPERATOR_AND);
+	if(expr->op == OPERATOR_IN)
+		return compile_in(expr->right, left);
+
+	if(expr->op != OPERATOR_AND || !as_cond)
+		return compile_binary(expr->op, left, compile(expr->right, false));
+
+	int jump = emit(OP_JUMP_FALSE, TERM_NULL, left);
+	int right = compile(expr->right, true);
+	int ret = compile_binary(expr->op, left, right);
+	// the right operand may be skipped if it raises no errors
+	if(prog[ret].op == OP_AND_B && !has_error(jump + 1, ret))
+		prog[jump].b = ret;
+	else prog[jump].op = OP_NOP;
+	return ret;
+}
+
+int compiled_expr::compile_column(const expr_node_t *expr)
+{
+	const char *table = expr->column_ref->table;
+	const row_view *found = nullptr;
+	int cid = -1;
+	for(const row_view *r : rows)
+	{
+		if(table && std::strcmp(r->table_name(), table) != 0)
+			continue;
+		int c = r->lookup_column(expr->column_ref->column);
+		if(c < 0) continue;
+		if(found) return emit_error(ERROR_COLUMN_NOT_UNIQUE);
+		found = r;
+		cid = c;
+	}
+
+	if(!found) return emit_error(ERROR_COLUMN_NOT_CACHED);
+
+	int id;
+	switch(found->column_type(cid))
+	{
+		case COL_TYPE_INT:
+			id = emit(OP_LOAD_I, TERM_INT);
+			break;
+		case COL_TYPE_DATE:
+			id = emit(OP_LOAD_I, TERM_DATE);
+			break;
+		case COL_TYPE_FLOAT:
+			id = emit(OP_LOAD_F, TERM_FLOAT);
+			break;
+		case COL_TYPE_VARCHAR:
+			id = emit(OP_LOAD_S, TERM_STRING);
+			break;
+		default:
+			return emit_error("[Error] wrong datatype.");
+	}
+
+	prog[id].row = found;
+	prog[id].cid = cid;
+	return id;
+}
+
+int compiled_expr::compile_in(const expr_node_t *expr, int left)
+{
+	if(expr->op != OPERATOR_NONE || expr->term_type != TERM_LITERAL_LIST)
+		return emit_error(ERROR_UNSUPPORTED_OPERATOR);
+
+	term_type_t type = types[left];
+	if(type == TERM_NULL)
+	{
+		expression f;
+		f.type = TERM_BOOL;
+		f.val_b = false;
+		return emit_const(f);
+	}
+
+	in_list_t list;
+	list.ordered = false;
+	for(linked_list_t *l = expr->literal_list; l; l = l->next)
+	{
+		const expr_node_t *val = (const expr_node_t*)l->data;
+		assert(val->op == OPERATOR_NONE);
+		const char *error = nullptr;
+		int i = 0;
+		float f = 0;
+		const char *s = nullptr;
+		switch(type)
+		{
+			case TERM_INT:
+				if(val->term_type == TERM_INT) i = val->val_i;
+				else error = ERROR_TYPE_INCOMPATIBLE;
+				break;
+			case TERM_FLOAT:
+				if(val->term_type == TERM_FLOAT) f = val->val_f;
+				else error = ERROR_TYPE_INCOMPATIBLE;
+				break;
+			case TERM_STRING:
+				if(val->term_type == TERM_STRING || val->term_type == TERM_DATE)
+					s = val->val_s;
+				else error = ERROR_TYPE_INCOMPATIBLE;
+				break;
+			case TERM_DATE:
+				if(val->term_type == TERM_DATE)
+				{
+					expression d = expression::eval(val);
+					// a literal which is not a date matches nothing
+					if(d.type != TERM_DATE) continue;
+					i = d.val_i;
+				} else {
+					error = ERROR_TYPE_INCOMPATIBLE;
+				}
+				break;
+			default:
+				error = ERROR_TYPE_INCOMPATIBLE;
+				break;
+		}
+
+		list.ints.push_back(i);
+		list.floats.push_back(f);
+		list.strings.push_back(s);
+		list.errors.push_back(error);
+		list.ordered |= error != nullptr;
+	}
+
+	if(!list.ordered)
+	{
+		list.errors.clear();
+		std::sort(list.ints.begin(), list.ints.end());
+		std::sort(list.floats.begin(), list.floats.end());
+		if(type == TERM_STRING)
+			std::sort(list.strings.begin(), list.strings.end(), less_str);
+	}
+
+	int op = OP_IN_I;
+	if(type == TERM_FLOAT) op = OP_IN_F;
+	else if(type == TERM_STRING) op = OP_IN_S;
+	int id = emit(op, TERM_BOOL, left);
+	prog[id].list = lists.size();
+	lists.push_back(std::move(list));
+	return id;
+}
+
+int compiled_expr::compile_binary(operator_type_t op, int left, int right)
+{
+	term_type_t tl = types[left], tr = types[right];
+	if(tl == TERM_NULL || tr == TERM_NULL)
+		return emit(OP_CONST_NULL, TERM_NULL);
+	if(tl != tr)
+		return emit_error(ERROR_TYPE_MISMATCH, left, right);
+
+	term_type_t type;
+	int opcode = binary_opcode(op, tl, &type);
+	if(opcode == OP_NOP)
+	{
+		if(tl == TERM_LITERAL_LIST)
+			return emit_error(ERROR_UNKNOWN_TYPE, left, right);
+		return emit_error(ERROR_UNSUPPORTED_OPERATOR, left, right);
+	}
+
+	return emit(opcode, type, left, right);
+}
+
+int compiled_expr::compile_unary(operator_type_t op, int left)
+{
+	term_type_t type = types[left];
+	if(type == TERM_NULL)
+	{
+		expression ret;
+		ret.type = TERM_NULL;
+		if(op == OPERATOR_ISNULL || op == OPERATOR_NOTNULL)
+		{
+			ret.type = TERM_BOOL;
+			ret.val_b = op == OPERATOR_ISNULL;
+		}
+
+		return emit_const(ret);
+	}
+
+	switch(op)
+	{
+		case OPERATOR_ISNULL:
+			return emit(OP_ISNULL, TERM_BOOL, left);
+		case OPERATOR_NOTNULL:
+			return emit(OP_NOTNULL, TERM_BOOL, left);
+		case OPERATOR_NEGATE:
+			if(type == TERM_INT)
+				return emit(OP_NEG_I, TERM_INT, left);
+			if(type == TERM_FLOAT)
+				return emit(OP_NEG_F, TERM_FLOAT, left);
+			break;
+		default:
+			break;
+	}
+
+	if(type == TERM_LITERAL_LIST)
+		return emit_error(ERROR_UNKNOWN_TYPE, left);
+	return emit_error(ERROR_UNSUPPORTED_OPERATOR, left);
+}
+
+#define BINARY_OP(field, expr) \
+	d.null = x.null | y.null; \
+	if(!d.null) d.val.field = (expr); \
+	break;
+
+void compiled_expr::run() const
+{
+	reg_t *r = regs.data();
+	for(int pc = 0, n = prog.size(); pc < n; ++pc)
+	{
+		const instr_t &in = prog[pc];
+		reg_t &d = r[pc];
+		const reg_t &x = r[in.a], &y = r[in.b];
+		switch(in.op)
+		{
+			case OP_NOP:
+				break;
+			case OP_CONST:
+				d.val = in.val;
+				d.null = false;
+				break;
+			case OP_CONST_NULL:
+				d.null = true;
+				break;
+			case OP_THROW:
+				throw in.error;
+			case OP_ERROR:
+				if(!x.null && !y.null)
+					throw in.error;
+				d.null = true;
+				break;
+			case OP_LOAD_I:
+			case OP_LOAD_F:
+			case OP_LOAD_S: {
+				if(!in.row->valid())
+					throw ERROR_COLUMN_NOT_CACHED;
+				const char *p = in.row->get_column(in.cid);
+				d.null = p == nullptr;
+				if(!p) break;
+				if(in.op == OP_LOAD_S) d.val.s = p;
+				else std::memcpy(&d.val, p, 4);
+				break;
+			}
+			case OP_ADD_I: BINARY_OP(i, x.val.i + y.val.i)
+			case OP_SUB_I: BINARY_OP(i, x.val.i - y.val.i)
+			case OP_MUL_I: BINARY_OP(i, x.val.i * y.val.i)
+			case OP_DIV_I: BINARY_OP(i, x.val.i / y.val.i)
+			case OP_NEG_I: BINARY_OP(i, -x.val.i)
+			case OP_ADD_F: BINARY_OP(f, x.val.f + y.val.f)
+			case OP_SUB_F: BINARY_OP(f, x.val.f - y.val.f)
+			case OP_MUL_F: BINARY_OP(f, x.val.f * y.val.f)
+			case OP_DIV_F: BINARY_OP(f, x.val.f / y.val.f)
+			case OP_NEG_F: BINARY_OP(f, -x.val.f)
+			case OP_EQ_I: BINARY_OP(b, x.val.i == y.val.i)
+			case OP_NE_I: BINARY_OP(b, x.val.i != y.val.i)
+			case OP_LT_I: BINARY_OP(b, x.val.i < y.val.i)
+			case OP_LE_I: BINARY_OP(b, x.val.i <= y.val.i)
+			case OP_GT_I: BINARY_OP(b, x.val.i > y.val.i)
+			case OP_GE_I: BINARY_OP(b, x.val.i >= y.val.i)
+			case OP_EQ_F: BINARY_OP(b, x.val.f == y.val.f)
+			case OP_NE_F: BINARY_OP(b, x.val.f != y.val.f)
+			case OP_LT_F: BINARY_OP(b, x.val.f < y.val.f)
+			case OP_LE_F: BINARY_OP(b, x.val.f <= y.val.f)
+			case OP_GT_F: BINARY_OP(b, x.val.f > y.val.f)
+			case OP_GE_F: BINARY_OP(b, x.val.f >= y.val.f)
+			case OP_EQ_B: BINARY_OP(b, x.val.b == y.val.b)
+			case OP_NE_B: BINARY_OP(b, x.val.b != y.val.b)
+			case OP_AND_B: BINARY_OP(b, x.val.b & y.val.b)
+			case OP_OR_B: BINARY_OP(b, x.val.b | y.val.b)
+			case OP_EQ_S: BINARY_OP(b, strcasecmp(x.val.s, y.val.s) == 0)
+			case OP_NE_S: BINARY_OP(b, strcasecmp(x.val.s, y.val.s) != 0)
+			case OP_LIKE_S: BINARY_OP(b, strlike(x.val.s, y.val.s))
+			case OP_ISNULL:
+				d.val.b = x.null;
+				d.null = false;
+				break;
+			case OP_NOTNULL:
+				d.val.b = !x.null;
+				d.null = false;
+				break;
+			case OP_IN_I:
+			case OP_IN_F:
+			case OP_IN_S: {
+				// NULL is in no list
+				d.null = false;
+				d.val.b = false;
+				if(x.null) break;
+				const in_list_t &list = lists[in.list];
+				if(list.ordered)
+				{
+					for(size_t k = 0; k != list.errors.size() && !d.val.b; ++k)
+					{
+						if(list.errors[k]) throw list.errors[k];
+						if(in.op == OP_IN_I) d.val.b = x.val.i == list.ints[k];
+						else if(in.op == OP_IN_F) d.val.b = x.val.f == list.floats[k];
+						else d.val.b = std::strcmp(x.val.s, list.strings[k]) == 0;
+					}
+				} else if(in.op == OP_IN_I) {
+					d.val.b = std::binary_search(list.ints.begin(), list.ints.end(), x.val.i);
+				} else if(in.op == OP_IN_F) {
+					d.val.b = std::binary_search(list.floats.begin(), list.floats.end(), x.val.f);
+				} else {
+					d.val.b = std::binary_search(list.strings.begin(),
+						list.strings.end(), x.val.s, less_str);
+				}
+				break;
+			}
+			case OP_JUMP_FALSE:
+				if(x.null || !x.val.b)
+				{
+					r[in.b].val.b = false;
+					r[in.b].null = false;
+					pc = in.b;
+				}
+				break;
+			default:
+				assert(0);
+				break;
+		}
+	}
+}
+
+#undef BINARY_OP
+
+expression compiled_expr::eval() const
+{
+	assert(!prog.empty());
+	run();
+	const reg_t &ret = regs.back();
+	expression val;
+	val.type = ret.null ? TERM_NULL : types.back();
+	switch(val.type)
+	{
+		case TERM_INT:
+		case TERM_DATE:
+			val.val_i = ret.val.i;
+			break;
+		case TERM_FLOAT:
+			val.val_f = ret.val.f;
+			break;
+		case TERM_BOOL:
+			val.val_b = ret.val.b;
+			break;
+		case TERM_STRING:
+			val.val_s = const_cast<char*>(ret.val.s);
+			break;
+		default:
+			break;
+	}
+
+	return val;
+}
+
+bool compiled_expr::eval_bool() const
+{
+	if(prog.empty()) return true;
+	run();
+	const reg_t &ret = regs.back();
+	if(ret.null) return false;
+	switch(types.back())
+	{
+		case TERM_INT:
+			return ret.val.i != 0;
+		case TERM_FLOAT:
+			return ret.val.f != 0;
+		case TERM_BOOL:
+			return ret.val.b;
+		case TERM_STRING:
+			return ret.val.s[0] != 0;
+		default:
+			return false;
+	}
+}
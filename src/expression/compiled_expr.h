@@ -0,0 +1,92 @@
+#ifndef __TRIVIALDB_COMPILED_EXPR__
+#define __TRIVIALDB_COMPILED_EXPR__
+
+#include <vector>
+#include "expression.h"
+
+class row_view;
+
+/* An expression compiled once per statement into a linear program.
+ * Column references are bound to the rows of the tables given when
+ * compiling, and the types of all the nodes are resolved, so each
+ * instruction is specialized to the types of its operands; constant
+ * subtrees are folded. Evaluating a row runs the instructions in order,
+ * the result of instruction i being kept in register i.
+ *
+ * The results and the errors are those of expression::eval. An error,
+ * such as a type mismatch, is raised by its instruction when it is run
+ * on operands that are not NULL, as the tree walk would. */
+
+class compiled_expr
+{
+	union value_t
+	{
+		int i;
+		float f;
+		bool b;
+		const char *s;
+	};
+
+	struct reg_t
+	{
+		value_t val;
+		bool null;
+	};
+
+	struct instr_t
+	{
+		int op;
+		int a, b;  // registers of the operands
+		union {
+			value_t val;           // constants
+			const char *error;     // errors
+			const row_view *row;   // columns
+			int list;              // IN lists
+		};
+		int cid;
+	};
+
+	// the literals of an IN list, sorted unless `ordered'
+	struct in_list_t
+	{
+		std::vector<int> ints;
+		std::vector<float> floats;
+		std::vector<const char*> strings;
+		// a literal of another type is an error once reached, in order
+		bool ordered;
+		std::vector<const char*> errors;
+	};
+
+	std::vector<instr_t> prog;
+	std::vector<term_type_t> types;
+	std::vector<in_list_t> lists;
+	std::vector<const row_view*> rows;
+	mutable std::vector<reg_t> regs;
+
+	int emit(int op, term_type_t type, int a = -1, int b = -1);
+	int emit_const(const expression &val);
+	int emit_error(const char *msg, int a = -1, int b = -1);
+	int compile(const expr_node_t *expr, bool as_cond);
+	int compile_column(const expr_node_t *expr);
+	int compile_in(const expr_node_t *expr, int left);
+	int compile_binary(operator_type_t op, int left, int right);
+	int compile_unary(operator_type_t op, int left);
+	bool has_error(int begin, int end) const;
+	void run() const;
+
+public:
+	compiled_expr() {}
+	/* the program of `expr', whose columns are those of `rows'. Only
+	 * eval_bool is used on a condition, which allows skipping the rest
+	 * of a conjunction once a term is not TRUE. */
+	compiled_expr(const expr_node_t *expr, const std::vector<const row_view*> &rows,
+			bool is_cond = false);
+	compiled_expr(const expr_node_t *expr, const row_view *row, bool is_cond = false);
+
+	bool empty() const { return prog.empty(); }
+	expression eval() const;
+	// the result as a condition, as typecast::expr_to_bool; TRUE if empty
+	bool eval_bool() const;
+};
+
+#endif
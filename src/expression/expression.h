@@ -17,13 +17,10 @@ struct expression
 
 	term_type_t type;
 
+	// column references are not bound, see compiled_expr
 	static expression eval(const expr_node_t *expr);
 	static std::string to_string(const expr_node_t *expr);
 	static bool is_aggregate(const expr_node_t *expr);
-	static void cache_clear();
-	static void cache_clear(const char *table);
-	static void cache_replace(const char *table, const char* col, expression expr);
-	static void cache_column(const char *table, const char *col, const expression &expr);
 
 	static void dump_exprnode(std::ostream &os, const expr_node_t *expr);
 	static expr_node_t* load_exprnode(std::istream &is);
@@ -57,6 +57,12 @@ public:
 		return nodes[head].prev;
 	}
 
+	// the one used just before `id'
+	int prev(int id) const
+	{
+		return nodes[id].prev;
+	}
+
 private:
 	int _check_valid() const
 	{
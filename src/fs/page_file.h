@@ -19,6 +19,8 @@ public:
 		return fid;
 	}
 
+	bool is_open() const { return fid; }
+
 	void close()
 	{
 		if(fid) 
@@ -36,6 +38,11 @@ public:
 		return page_fs::get_instance()->allocate(fid);
 	}
 
+	int new_pages(int num)
+	{
+		return page_fs::get_instance()->allocate_run(fid, num);
+	}
+
 	void free_page(int page_id)
 	{
 		page_fs::get_instance()->deallocate(fid, page_id);
@@ -55,6 +62,16 @@ public:
 	{
 		page_fs::get_instance()->mark_dirty(fid, page_id);
 	}
+
+	void pin(int page_id)
+	{
+		page_fs::get_instance()->pin(fid, page_id);
+	}
+
+	void unpin(int page_id)
+	{
+		page_fs::get_instance()->unpin(fid, page_id);
+	}
 };
 
 #endif
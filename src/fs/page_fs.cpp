@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <cstring>
+#include <vector>
 
 #include "page_fs.h"
 
@@ -6,6 +8,7 @@
 page_fs::page_fs()
 {
 	std::memset(dirty, 0, sizeof(dirty));
+	std::memset(pin_count, 0, sizeof(pin_count));
 	std::memset(index2page, 0, sizeof(index2page));
 }
 
@@ -32,11 +35,20 @@ int page_fs::open(const char* filename)
 	{
 		header.page_num       = 0;
 		header.first_freepage = 0;
+		header.version        = PAGE_FS_VERSION;
 		std::memset(tmp_buffer, 0, PAGE_SIZE);
 		std::memcpy(tmp_buffer, &header, sizeof(header));
 		std::fwrite(tmp_buffer, PAGE_SIZE, 1, f);
 	} else {
 		std::fread(&header, sizeof(header), 1, f);
+		if(header.version != PAGE_FS_VERSION)
+		{
+			std::fprintf(stderr, "[Error] `%s' has format version %d instead of %d.\n",
+					filename, header.version, PAGE_FS_VERSION);
+			std::fclose(f);
+			fm.deallocate(fid);
+			return 0;
+		}
 	}
 
 	files[fid] = f;
@@ -67,6 +79,7 @@ void page_fs::writeback(int file_id)
 			std::fwrite(buffer + i * PAGE_SIZE, PAGE_SIZE, 1, file);
 			page2index.erase(page2index.find(info));
 			index2page[i] = { 0, 0 };
+			pin_count[i] = 0;
 		}
 	}
 
@@ -96,6 +109,82 @@ int page_fs::allocate(int file_id)
 	return page_id;
 }
 
+int page_fs::allocate_run(int file_id, int num)
+{
+	assert(fm.is_used(file_id));
+	assert(num > 0);
+
+	page_fs_header_t &info = file_info[file_id];
+	int page_id = take_free_run(file_id, num);
+	if(page_id) return page_id;
+
+	// no free run, which is appended to the file
+	page_id = info.page_num + 1;
+	info.page_num += num;
+	std::memset(tmp_buffer, 0, PAGE_SIZE);
+	std::fseek(files[file_id], 0, SEEK_END);
+	for(int i = 0; i != num; ++i)
+		std::fwrite(tmp_buffer, PAGE_SIZE, 1, files[file_id]);
+
+	return page_id;
+}
+
+int page_fs::take_free_run(int file_id, int num)
+{
+	page_fs_header_t &info = file_info[file_id];
+	std::vector<int> free_pages;
+	int rest = info.first_freepage;
+	while(rest && free_pages.size() != FREE_RUN_SEARCH_MAX)
+	{
+		free_pages.push_back(rest);
+		rest = reinterpret_cast<const int*>(read(file_id, rest))[1];
+	}
+
+	if((int)free_pages.size() < num)
+		return 0;
+
+	std::vector<int> sorted(free_pages);
+	std::sort(sorted.begin(), sorted.end());
+	int first = 0;
+	for(size_t i = 0; i + num <= sorted.size(); ++i)
+	{
+		if(sorted[i + num - 1] - sorted[i] == num - 1)
+		{
+			first = sorted[i];
+			break;
+		}
+	}
+
+	if(!first) return 0;
+
+	// unlink the run, keeping the order of the other free pages
+	int last = 0;
+	auto link = [&](int next) {
+		if(!last)
+		{
+			info.first_freepage = next;
+			return;
+		}
+		int *data = reinterpret_cast<int*>(read(file_id, last));
+		if(data[1] != next)
+		{
+			data[1] = next;
+			mark_dirty(file_id, last);
+		}
+	};
+
+	for(int pid : free_pages)
+	{
+		if(first <= pid && pid < first + num)
+			continue;
+		link(pid);
+		last = pid;
+	}
+
+	link(rest);
+	return first;
+}
+
 void page_fs::deallocate(int file_id, int page_id)
 {
 	assert(fm.is_used(file_id));
@@ -118,8 +207,8 @@ char* page_fs::read(int file_id, int page_id, int& index)
 	if(it == page2index.end())
 	{
 		// not in cache
-		free_last_cache();
-		index = cm.last();
+		index = find_victim();
+		free_cache(index);
 		cm.access(index);
 		dirty[index] = 0;
 		page2index[key] = index;
@@ -148,20 +237,43 @@ void page_fs::write_page_to_file(int file_id, int page_id, const char* data)
 	std::fwrite(data, PAGE_SIZE, 1, files[file_id]);
 }
 
-void page_fs::free_last_cache()
+void page_fs::pin(int file_id, int page_id)
+{
+	int index;
+	read(file_id, page_id, index);
+	++pin_count[index];
+}
+
+void page_fs::unpin(int file_id, int page_id)
+{
+	auto it = page2index.find(file_page_t(file_id, page_id));
+	if(it != page2index.end() && pin_count[it->second])
+		--pin_count[it->second];
+}
+
+int page_fs::find_victim()
+{
+	// the least recently used page which is not pinned
+	int index = cm.last();
+	for(int i = 0; pin_count[index] && i != PAGE_CACHE_CAPACITY; ++i)
+		index = cm.prev(index);
+	assert(!pin_count[index]);
+	return index;
+}
+
+void page_fs::free_cache(int index)
 {
-	int last = cm.last();
-	file_page_t key = index2page[last];
+	file_page_t key = index2page[index];
 	if(key.first != 0)
 	{
-		if(dirty[last])
+		if(dirty[index])
 		{
 			debug_printf("Free cache and writeback: fid = %d, pid = %d\n", key.first, key.second);
-			write_page_to_file(key.first, key.second, buffer + last * PAGE_SIZE);
+			write_page_to_file(key.first, key.second, buffer + index * PAGE_SIZE);
 		}
 
 		page2index.erase(page2index.find(key));
-		index2page[last] = { 0, 0 };
+		index2page[index] = { 0, 0 };
 	}
 }
 
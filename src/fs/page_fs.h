@@ -11,11 +11,13 @@
 
 /* The first page is file info, not counted into `page_num`
  * `first_freepage` indicates the first freepage if it is not zero
- * and there is no freepage if it is zero */
+ * and there is no freepage if it is zero
+ * `version` is PAGE_FS_VERSION, files of other versions are not opened */
 struct page_fs_header_t
 {
 	int page_num;
 	int first_freepage;
+	int version;
 };
 
 class page_fs
@@ -30,6 +32,7 @@ class page_fs
 private:
 	/* cache */
 	char dirty[PAGE_CACHE_CAPACITY];
+	int pin_count[PAGE_CACHE_CAPACITY];  // pinned pages are never evicted
 	char buffer[PAGE_CACHE_CAPACITY * PAGE_SIZE];
 	char tmp_buffer[PAGE_SIZE];
 	cache_manager cm;
@@ -47,8 +50,11 @@ private:
 
 private:
 	char* read(int file_id, int page_id, int& index);
-	void free_last_cache();
+	int find_victim();
+	void free_cache(int index);
 	void write_page_to_file(int file_id, int page_id, const char* data);
+	// the first of `num` free pages with consecutive ids, unlinked, or 0
+	int take_free_run(int file_id, int num);
 
 private:
 	page_fs();
@@ -62,11 +68,19 @@ public:
 
 	/* allocate a new page */
 	int allocate(int file_id);
+	/* allocate `num` pages with consecutive ids, return the first; they
+	 * are taken from the free pages if possible */
+	int allocate_run(int file_id, int num);
 	/* free an existed page */
 	void deallocate(int file_id, int page_id);
 
 	void mark_dirty(int file_id, int page_id);
 
+	/* keep a cached page in memory, so that pointers into it stay valid
+	 * until it is unpinned */
+	void pin(int file_id, int page_id);
+	void unpin(int file_id, int page_id);
+
 	char* read(int file_id, int page_id) {
 		int index;
 		return read(file_id, page_id, index);
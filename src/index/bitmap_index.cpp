@@ -0,0 +1,174 @@
+#include "bitmap_index.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+/*    Directory
+ *  | value num | nullmark | key | bitmap page | ...
+ */
+
+bitmap_index::bitmap_index(pager *pg, int root_page_id, int key_size, comparer_t comparer)
+	: pg(pg), root_page_id(root_page_id), key_size(key_size), dir_dirty(false),
+	  values([comparer](const std::string &a, const std::string &b) -> bool {
+		  if(a[0] != b[0])
+			  return a[0] > b[0];  // NULL first
+		  return !a[0] && comparer(a.data() + 1, b.data() + 1) < 0;
+	  })
+{
+	if(root_page_id == 0)
+	{
+		this->root_page_id = write_chain(0, std::string(sizeof(int), 0));
+		return;
+	}
+
+	std::string dir;
+	read_chain(root_page_id, dir);
+	const char *p = dir.data();
+	int num = *(const int*)p;
+	p += sizeof(int);
+	for(int i = 0; i != num; ++i)
+	{
+		std::string key(p, key_size + 1);
+		p += key_size + 1;
+		values.emplace(key, value_t { *(const int*)p, false, false, {} });
+		p += sizeof(int);
+	}
+}
+
+std::string bitmap_index::make_key(const char *key)
+{
+	std::string ret(key_size + 1, 0);
+	if(key) std::memcpy(&ret[1], key, key_size);
+	else ret[0] = 1;
+	return ret;
+}
+
+bitmap_index::value_t &bitmap_index::load(value_t &value)
+{
+	if(!value.loaded)
+	{
+		std::string data;
+		read_chain(value.pid, data);
+		value.rids.deserialize(data.data(), data.size());
+		value.loaded = true;
+	}
+
+	return value;
+}
+
+void bitmap_index::insert(const char *key, int rid)
+{
+	auto it = values.find(make_key(key));
+	if(it == values.end())
+	{
+		it = values.emplace(make_key(key), value_t { 0, true, false, {} }).first;
+		dir_dirty = true;
+	}
+
+	value_t &value = load(it->second);
+	value.rids.add(rid);
+	value.dirty = true;
+}
+
+bool bitmap_index::erase(const char *key, int rid)
+{
+	auto it = values.find(make_key(key));
+	if(it == values.end())
+		return false;
+	value_t &value = load(it->second);
+	if(!value.rids.remove(rid))
+		return false;
+
+	if(value.rids.empty())
+	{
+		if(value.pid)
+			pg->free_overflow_page(value.pid);
+		values.erase(it);
+		dir_dirty = true;
+	} else {
+		value.dirty = true;
+	}
+
+	return true;
+}
+
+const rid_bitmap *bitmap_index::find(const char *key)
+{
+	auto it = values.find(make_key(key));
+	if(it == values.end())
+		return nullptr;
+	return &load(it->second).rids;
+}
+
+void bitmap_index::flush()
+{
+	std::string data;
+	for(auto &v : values)
+	{
+		if(!v.second.dirty) continue;
+		v.second.rids.serialize(data);
+		int pid = write_chain(v.second.pid, data);
+		dir_dirty |= pid != v.second.pid;
+		v.second.pid = pid;
+		v.second.dirty = false;
+	}
+
+	if(!dir_dirty) return;
+	int num = values.size();
+	data.assign((const char*)&num, sizeof(num));
+	for(auto &v : values)
+	{
+		data += v.first;
+		data.append((const char*)&v.second.pid, sizeof(int));
+	}
+
+	write_chain(root_page_id, data);
+	dir_dirty = false;
+}
+
+void bitmap_index::read_chain(int pid, std::string &data)
+{
+	data.clear();
+	while(pid)
+	{
+		overflow_page page { pg->read(pid), pg };
+		assert(page.magic() == PAGE_OVERFLOW);
+		data.append(page.block(), page.size());
+		pid = page.next();
+	}
+}
+
+int bitmap_index::write_chain(int pid, const std::string &data)
+{
+	// reuse the pages of the old chain starting at `pid'
+	bool reuse = pid != 0;
+	if(!reuse) pid = pg->new_page();
+	int first_pid = pid, offset = 0;
+	for(;;)
+	{
+		overflow_page page { pg->read_for_write(pid), pg };
+		int next = reuse ? page.next() : 0;
+		int size = std::min<int>(overflow_page::block_size(), data.size() - offset);
+		page.init();
+		page.size_ref() = size;
+		std::memcpy(page.block(), data.data() + offset, size);
+		offset += size;
+
+		if(offset == (int)data.size())
+		{
+			if(next) pg->free_overflow_page(next);
+			break;
+		}
+
+		if(!next)
+		{
+			reuse = false;
+			next = pg->new_page();
+		}
+
+		overflow_page { pg->read_for_write(pid), pg }.next_ref() = next;
+		pid = next;
+	}
+
+	return first_pid;
+}
@@ -0,0 +1,56 @@
+#ifndef __TRIVIALDB_BITMAP_INDEX__
+#define __TRIVIALDB_BITMAP_INDEX__
+#include <functional>
+#include <map>
+#include <string>
+#include "../page/pager.h"
+#include "rid_bitmap.h"
+
+/* Bitmap index for columns with few distinct values.
+ * Each distinct key (NULL included) owns a rid_bitmap, serialized into a
+ * chain of overflow pages. The root page starts the chain of the
+ * directory, which lists the keys and the first page of their bitmaps.
+ * Bitmaps are read on first use and written back by flush(). */
+
+class bitmap_index
+{
+public:
+	typedef std::function<int(const char*, const char*)> comparer_t;
+
+private:
+	struct value_t
+	{
+		int pid;  // first page of the bitmap, 0 if not written yet
+		bool loaded, dirty;
+		rid_bitmap rids;
+	};
+
+	typedef std::function<bool(const std::string&, const std::string&)> less_t;
+
+	pager *pg;
+	int root_page_id, key_size;
+	bool dir_dirty;
+	std::map<std::string, value_t, less_t> values;
+
+	std::string make_key(const char *key);
+	value_t &load(value_t &value);
+	void read_chain(int pid, std::string &data);
+	int write_chain(int pid, const std::string &data);
+
+public:
+	/* create/load a bitmap index
+	 * If root_page_id = 0, create a new index. */
+	bitmap_index(pager *pg, int root_page_id, int key_size, comparer_t comparer);
+
+	// key is nullptr for NULL
+	void insert(const char *key, int rid);
+	bool erase(const char *key, int rid);
+	// rids of the given key, nullptr if there is none
+	const rid_bitmap *find(const char *key);
+	int get_value_num() { return values.size(); }
+	void flush();
+
+	int get_root_page_id() { return root_page_id; }
+};
+
+#endif
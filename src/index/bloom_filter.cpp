@@ -0,0 +1,118 @@
+#include "bloom_filter.h"
+#include <cassert>
+#include <cstring>
+
+namespace {
+
+uint32_t mix_hash(uint32_t h)
+{
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35u;
+	h ^= h >> 16;
+	return h;
+}
+
+}
+
+bloom_filter::bloom_filter(pager *pg, int root_page_id, int key_size, hasher_t hasher)
+	: pg(pg), root_page_id(root_page_id), key_size(key_size), hasher(hasher)
+{
+	if(root_page_id == 0)
+	{
+		this->root_page_id = pg->new_page();
+		bloom_dir_page { pg->read_for_write(this->root_page_id), pg }.init();
+	} else {
+		load();
+	}
+}
+
+void bloom_filter::load()
+{
+	bloom_dir_page dir { pg->read(root_page_id), pg };
+	assert(dir.magic() == PAGE_BLOOM);
+	pages.assign(dir.pages(), dir.pages() + dir.page_num());
+}
+
+char *bloom_filter::locate(const char *key, bool dirty, uint64_t *bits)
+{
+	uint32_t h = hasher(key, key_size);
+	uint64_t g = (uint64_t)mix_hash(h ^ 0x9e3779b9u) << 32 | mix_hash(h + 0x7f4a7c15u);
+	int pid = pages[h % pages.size()];
+	char *buf = dirty ? pg->read_for_write(pid) : pg->read(pid);
+	constexpr int block_num = PAGE_SIZE * 8 / BLOOM_BLOCK_BITS;
+	buf += (g % block_num) * (BLOOM_BLOCK_BITS / 8);
+	*bits = g / block_num;
+	return buf;
+}
+
+void bloom_filter::add(const char *key)
+{
+	if(pages.empty()) return;
+	uint64_t bits;
+	char *block = locate(key, true, &bits);
+	for(int i = 0; i != BLOOM_HASH_NUM; ++i, bits /= BLOOM_BLOCK_BITS)
+	{
+		int b = bits % BLOOM_BLOCK_BITS;
+		block[b >> 3] |= 1 << (b & 7);
+	}
+
+	++bloom_dir_page { pg->read_for_write(root_page_id), pg }.keys_ref();
+}
+
+bool bloom_filter::may_contain(const char *key)
+{
+	if(pages.empty()) return true;
+	uint64_t bits;
+	const char *block = locate(key, false, &bits);
+	for(int i = 0; i != BLOOM_HASH_NUM; ++i, bits /= BLOOM_BLOCK_BITS)
+	{
+		int b = bits % BLOOM_BLOCK_BITS;
+		if(!((block[b >> 3] >> (b & 7)) & 1))
+			return false;
+	}
+
+	return true;
+}
+
+bool bloom_filter::is_stale()
+{
+	bloom_dir_page dir { pg->read(root_page_id), pg };
+	int capacity = dir.page_num() * (PAGE_SIZE * 8 / BLOOM_BITS_PER_KEY);
+	return dir.page_num() == 0 || dir.keys() > capacity;
+}
+
+void bloom_filter::reset(int expected_keys)
+{
+	free_bit_pages();
+	// leave room for twice the keys before the filter gets stale
+	int page_num = expected_keys * 2 / (PAGE_SIZE * 8 / BLOOM_BITS_PER_KEY) + 1;
+	if(page_num > BLOOM_MAX_PAGES)
+		page_num = BLOOM_MAX_PAGES;
+	for(int i = 0; i != page_num; ++i)
+	{
+		int pid = pg->new_page();
+		std::memset(pg->read_for_write(pid), 0, PAGE_SIZE);
+		pages.push_back(pid);
+	}
+
+	bloom_dir_page dir { pg->read_for_write(root_page_id), pg };
+	dir.page_num_ref() = page_num;
+	dir.keys_ref() = 0;
+	std::memcpy(dir.pages(), pages.data(), page_num * sizeof(int));
+}
+
+void bloom_filter::free_bit_pages()
+{
+	for(int pid : pages)
+		pg->free_page(pid);
+	pages.clear();
+}
+
+void bloom_filter::drop()
+{
+	free_bit_pages();
+	pg->free_page(root_page_id);
+	root_page_id = 0;
+}
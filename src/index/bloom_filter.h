@@ -0,0 +1,45 @@
+#ifndef __TRIVIALDB_BLOOM_FILTER__
+#define __TRIVIALDB_BLOOM_FILTER__
+#include <functional>
+#include <vector>
+#include "../page/pager.h"
+#include "../page/bloom_dir_page.h"
+
+/* Blocked bloom filter.
+ * A key is mapped to one block of BLOOM_BLOCK_BITS bits in one of the bit
+ * pages, and sets BLOOM_HASH_NUM bits inside it, so a probe touches a
+ * single page. Keys can not be removed; the filter is stale once more
+ * keys have been added than it is sized for, and should be rebuilt. */
+
+class bloom_filter
+{
+public:
+	typedef std::function<uint32_t(const char*, int)> hasher_t;
+
+private:
+	pager *pg;
+	int root_page_id, key_size;
+	hasher_t hasher;
+	std::vector<int> pages;
+
+	void load();
+	void free_bit_pages();
+	char *locate(const char *key, bool dirty, uint64_t *bits);
+
+public:
+	/* create/load a bloom filter
+	 * If root_page_id = 0, create an empty one, which is stale. */
+	bloom_filter(pager *pg, int root_page_id, int key_size, hasher_t hasher);
+
+	void add(const char *key);
+	bool may_contain(const char *key);
+	// drop all keys and resize for `expected_keys' keys
+	void reset(int expected_keys);
+	bool is_stale();
+	// free all pages of the filter
+	void drop();
+
+	int get_root_page_id() { return root_page_id; }
+};
+
+#endif
@@ -0,0 +1,118 @@
+#include "hash_index.h"
+
+hash_index::hash_index(pager *pg, int root_page_id, int field_size, hasher_t hasher, comparer_t compare)
+	: pg(pg), root_page_id(root_page_id), field_size(field_size),
+	  hasher(hasher), compare(compare)
+{
+	if(root_page_id == 0)
+	{
+		int bucket_pid = new_bucket();
+		this->root_page_id = pg->new_page();
+		hash_dir_page { pg->read_for_write(this->root_page_id), pg }.init(bucket_pid);
+	}
+}
+
+int hash_index::new_bucket()
+{
+	int pid = pg->new_page();
+	bucket_page page { pg->read_for_write(pid), pg };
+	page.init(field_size);
+	page.magic_ref() = PAGE_HASH_BUCKET;
+	return pid;
+}
+
+int hash_index::find_bucket(const char *key)
+{
+	hash_dir_page dir { pg->read(root_page_id), pg };
+	assert(dir.magic() == PAGE_HASH_DIR);
+	return dir.buckets()[hasher(key) & (dir.size() - 1)];
+}
+
+void hash_index::split(int slot)
+{
+	int new_pid = new_bucket();
+	hash_dir_page dir { pg->read_for_write(root_page_id), pg };
+	int depth = dir.local_depth()[slot];
+	if(depth == dir.global_depth())
+		dir.expand();
+
+	int old_pid = dir.buckets()[slot];
+	for(int i = 0; i != dir.size(); ++i)
+	{
+		if(dir.buckets()[i] != old_pid)
+			continue;
+		dir.local_depth()[i] = depth + 1;
+		if((i >> depth) & 1)
+			dir.buckets()[i] = new_pid;
+	}
+
+	bucket_page lower { pg->read_for_write(old_pid), pg };
+	bucket_page upper { pg->read_for_write(new_pid), pg };
+	assert(lower.next_page() == 0);
+	for(int i = 0; i < lower.size(); )
+	{
+		if((hasher(lower.get_key(i)) >> depth) & 1)
+			upper.move_from(lower, i, upper.size());
+		else ++i;
+	}
+}
+
+void hash_index::insert(const char *key, int rid)
+{
+	uint32_t h = hasher(key);
+	for(;;)
+	{
+		hash_dir_page dir { pg->read(root_page_id), pg };
+		int slot = h & (dir.size() - 1);
+		int pid = dir.buckets()[slot];
+		bucket_page page { pg->read_for_write(pid), pg };
+		if(!page.full())
+		{
+			page.insert(page.size(), key, rid);
+			return;
+		}
+
+		if(dir.local_depth()[slot] < HASH_MAX_GLOBAL_DEPTH)
+		{
+			split(slot);
+			continue;
+		}
+
+		// the directory is full, use overflow buckets
+		while(page.full())
+		{
+			if(!page.next_page())
+			{
+				int next_pid = new_bucket();
+				page = bucket_page { pg->read_for_write(pid), pg };
+				page.next_page_ref() = next_pid;
+			}
+
+			pid = page.next_page();
+			page = bucket_page { pg->read_for_write(pid), pg };
+		}
+
+		page.insert(page.size(), key, rid);
+		return;
+	}
+}
+
+bool hash_index::erase(const char *key)
+{
+	for(int pid = find_bucket(key); pid; )
+	{
+		bucket_page page { pg->read(pid), pg };
+		for(int i = 0; i != page.size(); ++i)
+		{
+			if(compare(page.get_key(i), key) == 0)
+			{
+				bucket_page { pg->read_for_write(pid), pg }.erase(i);
+				return true;
+			}
+		}
+
+		pid = page.next_page();
+	}
+
+	return false;
+}
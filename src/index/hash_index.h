@@ -0,0 +1,45 @@
+#ifndef __TRIVIALDB_HASH_INDEX__
+#define __TRIVIALDB_HASH_INDEX__
+#include <functional>
+#include "../page/pager.h"
+#include "../page/hash_dir_page.h"
+#include "../page/index_leaf_page.h"
+
+/* Extendible hashing.
+ * The root page is the directory, which maps the lowest `global depth`
+ * bits of the hash value to bucket pages. Buckets have the same layout
+ * as the leaves of index_btree, but are not sorted. A bucket is split
+ * when full, and chained with overflow buckets (by next_page) only when
+ * the directory can not grow any more. */
+
+class hash_index
+{
+public:
+	typedef std::function<uint32_t(const char*)> hasher_t;
+	typedef std::function<int(const char*, const char*)> comparer_t;
+	typedef index_leaf_page<const char*> bucket_page;
+
+private:
+	pager *pg;
+	int root_page_id, field_size;
+	hasher_t hasher;
+	comparer_t compare;
+
+	int new_bucket();
+	void split(int slot);
+
+public:
+	/* create/load a hash index
+	 * If root_page_id = 0, create a new index.
+	 * If root_page_id != 0, load an existed index */
+	hash_index(pager *pg, int root_page_id, int field_size, hasher_t hasher, comparer_t compare);
+
+	void insert(const char *key, int rid);
+	bool erase(const char *key);
+	// the first page of the bucket which key belongs to
+	int find_bucket(const char *key);
+
+	int get_root_page_id() { return root_page_id; }
+};
+
+#endif
@@ -1,43 +1,72 @@
 #include "index.h"
 #include "../utils/comparer.h"
+#include <algorithm>
+#include <cassert>
 #include <cstring>
 
-index_manager::index_manager(pager *pg, int size, int root_pid, comparer_t comparer)
+index_manager::index_manager(pager *pg, int size, int root_pid, comparer_t comparer,
+	int payload_size, hasher_t hasher)
 {
 	this->pg = pg;
 	this->size = size;
-	// [rid, nullmark, data]
-	buf = new char[size + sizeof(int) + 1];
-	btr = new index_btree(pg, root_pid, size + sizeof(int) + 1,
-		[comparer](const char *a, const char *b) -> int {
-			if(a[4] != b[4])
-			{
-				// one of A and B is NULL
-				return a[4] ? -1 : 1;
-			} else if(!a[4]) {
-				// A and B are not NULL
-				int r = comparer(a + sizeof(int) + 1, b + sizeof(int) + 1);
-				if(r != 0) return r;
-			}
-
-			return integer_comparer(*(int*)a, *(int*)b);
-		} );
+	this->payload_size = payload_size;
+	this->comparer = comparer;
+	// [rid, nullmark, data, payload]
+	buf = new char[size + payload_size + sizeof(int) + 1];
+	entry_comparer = [comparer](const char *a, const char *b) -> int {
+		if(a[4] != b[4])
+		{
+			// one of A and B is NULL
+			return a[4] ? -1 : 1;
+		} else if(!a[4]) {
+			// A and B are not NULL
+			int r = comparer(a + sizeof(int) + 1, b + sizeof(int) + 1);
+			if(r != 0) return r;
+		}
+
+		return integer_comparer(*(int*)a, *(int*)b);
+	};
+
+	btr = nullptr;
+	hsh = nullptr;
+	bloom = nullptr;
+	if(hasher)
+	{
+		hsh = new hash_index(pg, root_pid, size + payload_size + sizeof(int) + 1,
+			[hasher, size](const char *a) -> uint32_t {
+				// all NULLs are in the same bucket
+				return a[4] ? 0 : hasher(a + sizeof(int) + 1, size);
+			}, entry_comparer);
+	} else {
+		btr = new index_btree(pg, root_pid, size + payload_size + sizeof(int) + 1,
+			entry_comparer);
+	}
 }
 
 index_manager::~index_manager()
 {
 	delete []buf;
 	delete btr;
+	delete hsh;
+	delete bloom;
 	buf = nullptr;
 	btr = nullptr;
+	hsh = nullptr;
+	bloom = nullptr;
+}
+
+void index_manager::open_bloom_filter(int root_pid, hasher_t hasher)
+{
+	assert(bloom == nullptr);
+	bloom = new bloom_filter(pg, root_pid, size, hasher);
 }
 
 int index_manager::get_root_pid()
 {
-	return btr->get_root_page_id();
+	return hsh ? hsh->get_root_page_id() : btr->get_root_page_id();
 }
 
-void index_manager::fill_buf(const char *key, int rid)
+void index_manager::fill_buf(const char *key, int rid, const char *payload)
 {
 	*(int*)buf = rid;
 	if(key != nullptr)
@@ -48,24 +77,95 @@ void index_manager::fill_buf(const char *key, int rid)
 		buf[4] = 1;
 		std::memset(buf + sizeof(int) + 1, 0, size);
 	}
+
+	if(payload_size)
+	{
+		char *dest = buf + sizeof(int) + 1 + size;
+		if(payload != nullptr)
+			std::memcpy(dest, payload, payload_size);
+		else std::memset(dest, 0, payload_size);
+	}
 }
 
-void index_manager::insert(const char *key, int rid)
+bool index_manager::key_equal(const char *a, const char *b)
 {
-	fill_buf(key, rid);
-	btr->insert(buf, rid);
+	if(a[4] != b[4]) return false;
+	return a[4] || comparer(a + sizeof(int) + 1, b + sizeof(int) + 1) == 0;
+}
+
+void index_manager::insert(const char *key, int rid, const char *payload)
+{
+	fill_buf(key, rid, payload);
+	if(hsh) hsh->insert(buf, rid);
+	else btr->insert(buf, rid);
+	if(bloom && key) bloom->add(key);
+}
+
+void index_manager::insert_later(const char *key, int rid, const char *payload)
+{
+	fill_buf(key, rid, payload);
+	pending_insert.emplace_back(buf, size + payload_size + sizeof(int) + 1);
+}
+
+void index_manager::insert_pending()
+{
+	// consecutive entries mostly go to the same leaf
+	std::sort(pending_insert.begin(), pending_insert.end(),
+		[this](const std::string &a, const std::string &b) {
+			return entry_comparer(a.data(), b.data()) < 0;
+		} );
+
+	for(const std::string &entry : pending_insert)
+	{
+		int rid = entry_rid(entry.data());
+		if(hsh) hsh->insert(entry.data(), rid);
+		else btr->insert(entry.data(), rid);
+		const char *key = entry_key(entry.data());
+		if(bloom && key) bloom->add(key);
+	}
+
+	pending_insert.clear();
 }
 
 void index_manager::erase(const char *key, int rid)
 {
 	fill_buf(key, rid);
-	bool ret = btr->erase(buf);
+	bool ret = hsh ? hsh->erase(buf) : btr->erase(buf);
 	assert(ret);
 	UNUSED(ret);
 }
 
+void index_manager::erase_later(const char *key, int rid)
+{
+	fill_buf(key, rid);
+	pending_erase.emplace_back(buf, size + payload_size + sizeof(int) + 1);
+}
+
+void index_manager::erase_pending()
+{
+	if(hsh)
+	{
+		for(const std::string &entry : pending_erase)
+		{
+			bool ret = hsh->erase(entry.data());
+			assert(ret);
+			UNUSED(ret);
+		}
+	} else {
+		std::vector<const char*> keys;
+		for(const std::string &entry : pending_erase)
+			keys.push_back(entry.data());
+		int ret = btr->erase_batch(keys);
+		assert(ret == (int)keys.size());
+		UNUSED(ret);
+	}
+
+	pending_erase.clear();
+}
+
 index_btree::search_result index_manager::lower_bound(const char *key, int rid)
 {
+	assert(btr);
 	fill_buf(key, rid);
 	return btr->lower_bound(buf);
 }
@@ -75,3 +175,53 @@ btree_iterator<index_btree::leaf_page> index_manager::get_iterator_lower_bound(c
 	auto ret = lower_bound(key, rid);
 	return { pg, ret.first, ret.second };
 }
+
+index_manager::equal_iterator index_manager::get_equal_iterator(const char *key)
+{
+	if(bloom && key && !bloom->may_contain(key))
+	{
+		fill_buf(key, 0);
+		return { this, buf, { 0, 0 } };
+	} else if(hsh)
+	{
+		fill_buf(key, 0);
+		return { this, buf, { hsh->find_bucket(buf), 0 } };
+	} else {
+		auto ret = lower_bound(key);
+		return { this, buf, ret };
+	}
+}
+
+const char *index_manager::get_entry(std::pair<int, int> pos)
+{
+	index_btree::leaf_page page { pg->read(pos.first), pg };
+	return page.get_key(pos.second);
+}
+
+index_manager::equal_iterator::equal_iterator(
+	index_manager *index, const char *entry, std::pair<int, int> start)
+	: idx(index), key(entry, index->size + sizeof(int) + 1),
+	  pid(start.first), pos(start.second)
+{
+	seek();
+}
+
+void index_manager::equal_iterator::seek()
+{
+	while(pid)
+	{
+		index_btree::leaf_page page { idx->pg->read(pid), idx->pg };
+		if(pos >= page.size())
+		{
+			pid = page.next_page();
+			pos = 0;
+		} else if(idx->key_equal(page.get_key(pos), key.data())) {
+			return;
+		} else if(idx->hsh) {
+			// entries in a bucket are not sorted
+			++pos;
+		} else {
+			pid = 0;
+		}
+	}
+}
@@ -1,30 +1,85 @@
 #ifndef __TRIVIALDB_INDEX__
 #define __TRIVIALDB_INDEX__
 #include <functional>
+#include <string>
+#include <vector>
 #include "../btree/btree.h"
 #include "../btree/iterator.h"
+#include "hash_index.h"
+#include "bloom_filter.h"
+
+/*    Entry structure of index
+ *  | rid | nullmark | key | payload (included columns) |
+ */
 
 class index_manager
 {
+public:
+	typedef std::function<int(const char*, const char*)> comparer_t;
+	typedef std::function<uint32_t(const char*, int)> hasher_t;
+
+	// iterate entries whose key equals to the given one
+	class equal_iterator
+	{
+		index_manager *idx;
+		std::string key;
+		int pid, pos;
+		void seek();
+	public:
+		equal_iterator(index_manager *index, const char *entry, std::pair<int, int> start);
+		bool is_end() { return pid == 0; }
+		std::pair<int, int> get() { return { pid, pos }; }
+		void next() { ++pos; seek(); }
+	};
+
+private:
 	char *buf;
 	index_btree *btr;
-	int size;
+	hash_index *hsh;
+	bloom_filter *bloom;
+	int size, payload_size;
 	pager *pg;
+	comparer_t comparer, entry_comparer;
+	std::vector<std::string> pending_insert, pending_erase;
 
-	void fill_buf(const char *key, int rid);
+	void fill_buf(const char *key, int rid, const char *payload = nullptr);
+	bool key_equal(const char *a, const char *b);
 
 public:
-	typedef int(*comparer_t)(const char*, const char*);
-
-	index_manager(pager *pg, int size, int root_pid, comparer_t comparer);
+	/* Use hash index instead of btree if hasher is given,
+	 * which supports only equality lookups */
+	index_manager(pager *pg, int size, int root_pid, comparer_t comparer,
+		int payload_size = 0, hasher_t hasher = nullptr);
 	~index_manager();
 
 	int get_root_pid();
-	void insert(const char *key, int rid);
+	int get_payload_size() { return payload_size; }
+	bool is_hash() { return hsh != nullptr; }
+	/* Keep a bloom filter of the keys, so that lookups of absent
+	 * keys return without searching the index */
+	void open_bloom_filter(int root_pid, hasher_t hasher);
+	bloom_filter *get_bloom_filter() { return bloom; }
+	void insert(const char *key, int rid, const char *payload = nullptr);
+	// queue an insertion, and the queued ones are done in key order by insert_pending
+	void insert_later(const char *key, int rid, const char *payload = nullptr);
+	void insert_pending();
 	void erase(const char *key, int rid);
+	// queue an erase, and the queued ones are done in a batch by erase_pending
+	void erase_later(const char *key, int rid);
+	void erase_pending();
 	index_btree::search_result lower_bound(const char *key, int rid = 0);
 	btree_iterator<index_btree::leaf_page> get_iterator_lower_bound(const char *key, int rid = 0);
+	equal_iterator get_equal_iterator(const char *key);
 
+	// access the entry stored at `pos` (returned by lower_bound or iterators)
+	const char *get_entry(std::pair<int, int> pos);
+	static int entry_rid(const char *entry) { return *(const int*)entry; }
+	static const char *entry_key(const char *entry) {
+		return entry[sizeof(int)] ? nullptr : entry + sizeof(int) + 1;
+	}
+	const char *entry_payload(const char *entry) {
+		return entry + sizeof(int) + 1 + size;
+	}
 };
 
 #endif
@@ -0,0 +1,304 @@
+#include "rid_bitmap.h"
+#include "../defs.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iterator>
+
+bool rid_bitmap::container::contains(uint16_t low) const
+{
+	if(is_bitmap())
+		return (bits[low >> 6] >> (low & 63)) & 1;
+	return std::binary_search(array.begin(), array.end(), low);
+}
+
+void rid_bitmap::container::add(uint16_t low)
+{
+	if(!is_bitmap())
+	{
+		if(array.empty() || array.back() < low)
+		{
+			array.push_back(low);
+		} else {
+			auto it = std::lower_bound(array.begin(), array.end(), low);
+			if(*it == low) return;
+			array.insert(it, low);
+		}
+
+		if(++cardinality > ARRAY_MAX_SIZE)
+			to_bitmap();
+		return;
+	}
+
+	uint64_t mask = (uint64_t)1 << (low & 63);
+	if(!(bits[low >> 6] & mask))
+	{
+		bits[low >> 6] |= mask;
+		++cardinality;
+	}
+}
+
+bool rid_bitmap::container::remove(uint16_t low)
+{
+	if(!is_bitmap())
+	{
+		auto it = std::lower_bound(array.begin(), array.end(), low);
+		if(it == array.end() || *it != low)
+			return false;
+		array.erase(it);
+		--cardinality;
+		return true;
+	}
+
+	uint64_t mask = (uint64_t)1 << (low & 63);
+	if(!(bits[low >> 6] & mask))
+		return false;
+	bits[low >> 6] &= ~mask;
+	if(--cardinality <= ARRAY_MAX_SIZE)
+		to_array();
+	return true;
+}
+
+void rid_bitmap::container::to_bitmap()
+{
+	if(is_bitmap()) return;
+	bits.assign(BITMAP_WORDS, 0);
+	for(uint16_t low : array)
+		bits[low >> 6] |= (uint64_t)1 << (low & 63);
+	std::vector<uint16_t>().swap(array);
+}
+
+void rid_bitmap::container::to_array()
+{
+	if(!is_bitmap()) return;
+	array.clear();
+	array.reserve(cardinality);
+	for(int i = 0; i != BITMAP_WORDS; ++i)
+	{
+		for(uint64_t w = bits[i]; w; w &= w - 1)
+			array.push_back(i * 64 + __builtin_ctzll(w));
+	}
+
+	std::vector<uint64_t>().swap(bits);
+}
+
+void rid_bitmap::container::intersect_with(const container &other)
+{
+	if(is_bitmap() && other.is_bitmap())
+	{
+		cardinality = 0;
+		for(int i = 0; i != BITMAP_WORDS; ++i)
+		{
+			bits[i] &= other.bits[i];
+			cardinality += __builtin_popcountll(bits[i]);
+		}
+
+		if(cardinality <= ARRAY_MAX_SIZE)
+			to_array();
+	} else if(is_bitmap()) {
+		std::vector<uint16_t> result;
+		for(uint16_t low : other.array)
+			if(contains(low))
+				result.push_back(low);
+		std::vector<uint64_t>().swap(bits);
+		array.swap(result);
+		cardinality = array.size();
+	} else {
+		auto end = std::remove_if(array.begin(), array.end(),
+			[&](uint16_t low) { return !other.contains(low); });
+		array.erase(end, array.end());
+		cardinality = array.size();
+	}
+}
+
+void rid_bitmap::container::union_with(const container &other)
+{
+	if(!is_bitmap() && !other.is_bitmap()
+		&& cardinality + other.cardinality <= ARRAY_MAX_SIZE)
+	{
+		std::vector<uint16_t> result;
+		std::set_union(array.begin(), array.end(),
+			other.array.begin(), other.array.end(),
+			std::back_inserter(result));
+		array.swap(result);
+		cardinality = array.size();
+		return;
+	}
+
+	to_bitmap();
+	if(other.is_bitmap())
+	{
+		cardinality = 0;
+		for(int i = 0; i != BITMAP_WORDS; ++i)
+		{
+			bits[i] |= other.bits[i];
+			cardinality += __builtin_popcountll(bits[i]);
+		}
+	} else {
+		for(uint16_t low : other.array)
+			add(low);
+	}
+
+	if(cardinality <= ARRAY_MAX_SIZE)
+		to_array();
+}
+
+int rid_bitmap::find(uint16_t high) const
+{
+	auto it = std::lower_bound(containers.begin(), containers.end(), high,
+		[](const container &c, uint16_t h) { return c.high < h; });
+	if(it == containers.end() || it->high != high)
+		return -1;
+	return it - containers.begin();
+}
+
+void rid_bitmap::add(int rid)
+{
+	assert(rid >= 0);
+	uint16_t high = (uint32_t)rid >> 16, low = rid & 0xffff;
+	if(containers.empty() || containers.back().high < high)
+	{
+		containers.push_back(container { high, 0, {}, {} });
+		containers.back().add(low);
+		return;
+	}
+
+	auto it = std::lower_bound(containers.begin(), containers.end(), high,
+		[](const container &c, uint16_t h) { return c.high < h; });
+	if(it->high != high)
+		it = containers.insert(it, container { high, 0, {}, {} });
+	it->add(low);
+}
+
+bool rid_bitmap::remove(int rid)
+{
+	int idx = find((uint32_t)rid >> 16);
+	if(idx < 0 || !containers[idx].remove(rid & 0xffff))
+		return false;
+	if(containers[idx].cardinality == 0)
+		containers.erase(containers.begin() + idx);
+	return true;
+}
+
+bool rid_bitmap::contains(int rid) const
+{
+	int idx = find((uint32_t)rid >> 16);
+	return idx >= 0 && containers[idx].contains(rid & 0xffff);
+}
+
+int rid_bitmap::size() const
+{
+	int size = 0;
+	for(const container &c : containers)
+		size += c.cardinality;
+	return size;
+}
+
+void rid_bitmap::intersect_with(const rid_bitmap &other)
+{
+	std::vector<container> result;
+	for(container &c : containers)
+	{
+		int idx = other.find(c.high);
+		if(idx < 0) continue;
+		c.intersect_with(other.containers[idx]);
+		if(c.cardinality)
+			result.push_back(std::move(c));
+	}
+
+	containers.swap(result);
+}
+
+void rid_bitmap::union_with(const rid_bitmap &other)
+{
+	std::vector<container> result;
+	auto a = containers.begin();
+	auto b = other.containers.begin();
+	while(a != containers.end() || b != other.containers.end())
+	{
+		if(b == other.containers.end() || (a != containers.end() && a->high < b->high))
+		{
+			result.push_back(std::move(*a++));
+		} else if(a == containers.end() || b->high < a->high) {
+			result.push_back(*b++);
+		} else {
+			a->union_with(*b++);
+			result.push_back(std::move(*a++));
+		}
+	}
+
+	containers.swap(result);
+}
+
+void rid_bitmap::to_vector(std::vector<int> &rids) const
+{
+	rids.clear();
+	rids.reserve(size());
+	for(const container &c : containers)
+	{
+		int base = (int)c.high << 16;
+		if(!c.is_bitmap())
+		{
+			for(uint16_t low : c.array)
+				rids.push_back(base | low);
+			continue;
+		}
+
+		for(int i = 0; i != BITMAP_WORDS; ++i)
+		{
+			for(uint64_t w = c.bits[i]; w; w &= w - 1)
+				rids.push_back(base | (i * 64 + __builtin_ctzll(w)));
+		}
+	}
+}
+
+/*    Serialized format
+ *  | container num | high | cardinality | array or bits | ...
+ */
+void rid_bitmap::serialize(std::string &data) const
+{
+	auto append = [&](const void *src, int size) {
+		data.append((const char*)src, size);
+	};
+
+	data.clear();
+	int num = containers.size();
+	append(&num, sizeof(num));
+	for(const container &c : containers)
+	{
+		append(&c.high, sizeof(c.high));
+		append(&c.cardinality, sizeof(c.cardinality));
+		if(c.is_bitmap())
+			append(c.bits.data(), BITMAP_WORDS * sizeof(uint64_t));
+		else append(c.array.data(), c.cardinality * sizeof(uint16_t));
+	}
+}
+
+void rid_bitmap::deserialize(const char *data, int size)
+{
+	const char *end = data + size;
+	auto fetch = [&](void *dest, int len) {
+		assert(data + len <= end);
+		std::memcpy(dest, data, len);
+		data += len;
+	};
+
+	int num;
+	fetch(&num, sizeof(num));
+	containers.assign(num, container { 0, 0, {}, {} });
+	for(container &c : containers)
+	{
+		fetch(&c.high, sizeof(c.high));
+		fetch(&c.cardinality, sizeof(c.cardinality));
+		if(c.cardinality > ARRAY_MAX_SIZE)
+		{
+			c.bits.resize(BITMAP_WORDS);
+			fetch(c.bits.data(), BITMAP_WORDS * sizeof(uint64_t));
+		} else {
+			c.array.resize(c.cardinality);
+			fetch(c.array.data(), c.cardinality * sizeof(uint16_t));
+		}
+	}
+
+	UNUSED(end);
+}
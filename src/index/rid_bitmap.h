@@ -0,0 +1,52 @@
+#ifndef __TRIVIALDB_RID_BITMAP__
+#define __TRIVIALDB_RID_BITMAP__
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/* Compressed set of rids (roaring bitmap).
+ * Rids are grouped by their high 16 bits into containers. A container
+ * keeps the sorted low 16 bits in an array while it has at most
+ * ARRAY_MAX_SIZE elements, and a bitmap of 2^16 bits otherwise. */
+
+class rid_bitmap
+{
+	static constexpr int ARRAY_MAX_SIZE = 4096;
+	static constexpr int BITMAP_WORDS = 65536 / 64;
+
+	struct container
+	{
+		uint16_t high;
+		int cardinality;
+		std::vector<uint16_t> array;  // used if bits is empty
+		std::vector<uint64_t> bits;
+
+		bool is_bitmap() const { return !bits.empty(); }
+		bool contains(uint16_t low) const;
+		void add(uint16_t low);
+		bool remove(uint16_t low);
+		void to_bitmap();
+		void to_array();
+		void intersect_with(const container &other);
+		void union_with(const container &other);
+	};
+
+	std::vector<container> containers;  // sorted by high
+	int find(uint16_t high) const;
+
+public:
+	void add(int rid);
+	bool remove(int rid);
+	bool contains(int rid) const;
+	int size() const;
+	bool empty() const { return containers.empty(); }
+	void intersect_with(const rid_bitmap &other);
+	void union_with(const rid_bitmap &other);
+	// all rids in increasing order
+	void to_vector(std::vector<int> &rids) const;
+
+	void serialize(std::string &data) const;
+	void deserialize(const char *data, int size);
+};
+
+#endif
@@ -0,0 +1,118 @@
+#include "trigram_index.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+/* literal runs of a LIKE pattern, split at wildcards; false if the pattern
+ * has characters which are passed to the regex unescaped (see strlike), as
+ * these may make their neighbours optional, e.g. `abc?' or `a|b' */
+bool like_literal_runs(const char *pattern, std::vector<std::string> &runs)
+{
+	std::string run;
+	auto cut = [&]() {
+		if(run.size() >= 3)
+			runs.push_back(run);
+		run.clear();
+	};
+
+	for(const char *p = pattern; *p; ++p)
+	{
+		if(*p == '\\')
+		{
+			if(p[1] != '%' && p[1] != '_')
+				return false;
+			run.push_back(*++p);
+		} else if(std::strchr("[]{}()*+?^$|", *p)) {
+			return false;
+		} else if(*p == '%' || *p == '_' || *p == '.') {
+			cut();
+		} else {
+			run.push_back(*p);
+		}
+	}
+
+	cut();
+	return true;
+}
+
+}
+
+trigram_index::trigram_index(pager *pg, int root_page_id, int max_length)
+	: postings(pg, root_page_id, 3, [](const char *a, const char *b) -> int {
+		  return std::memcmp(a, b, 3);
+	  }),
+	  max_length(max_length)
+{
+}
+
+void trigram_index::split(const char *str, std::vector<std::string> &grams)
+{
+	grams.clear();
+	int len = strnlen(str, max_length);
+	for(int i = 0; i + 3 <= len; ++i)
+		grams.emplace_back(str + i, 3);
+	std::sort(grams.begin(), grams.end());
+	grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+}
+
+void trigram_index::insert(const char *str, int rid)
+{
+	std::vector<std::string> grams;
+	split(str, grams);
+	for(const std::string &g : grams)
+		postings.insert(g.data(), rid);
+}
+
+void trigram_index::erase(const char *str, int rid)
+{
+	std::vector<std::string> grams;
+	split(str, grams);
+	for(const std::string &g : grams)
+		postings.erase(g.data(), rid);
+}
+
+bool trigram_index::searchable(const char *pattern)
+{
+	std::vector<std::string> runs;
+	return like_literal_runs(pattern, runs) && !runs.empty();
+}
+
+bool trigram_index::search(const char *pattern, rid_bitmap &rids)
+{
+	std::vector<std::string> runs, grams;
+	if(!like_literal_runs(pattern, runs))
+		return false;
+	for(const std::string &run : runs)
+	{
+		for(size_t i = 0; i + 3 <= run.size(); ++i)
+			grams.push_back(run.substr(i, 3));
+	}
+
+	if(grams.empty()) return false;
+	std::sort(grams.begin(), grams.end());
+	grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+
+	// rarest trigrams first, so that the candidates shrink quickly
+	std::vector<const rid_bitmap*> lists;
+	for(const std::string &g : grams)
+	{
+		const rid_bitmap *list = postings.find(g.data());
+		if(!list)
+		{
+			rids = rid_bitmap();
+			return true;
+		}
+
+		lists.push_back(list);
+	}
+
+	std::sort(lists.begin(), lists.end(), [](const rid_bitmap *a, const rid_bitmap *b) {
+		return a->size() < b->size();
+	} );
+
+	rids = *lists[0];
+	for(size_t i = 1; i != lists.size() && !rids.empty(); ++i)
+		rids.intersect_with(*lists[i]);
+	return true;
+}
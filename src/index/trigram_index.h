@@ -0,0 +1,35 @@
+#ifndef __TRIVIALDB_TRIGRAM_INDEX__
+#define __TRIVIALDB_TRIGRAM_INDEX__
+#include <string>
+#include <vector>
+#include "bitmap_index.h"
+
+/* Inverted trigram index of a VARCHAR column.
+ * The posting list of each trigram is a rid bitmap in a bitmap_index.
+ * A LIKE pattern is answered by intersecting the posting lists of the
+ * trigrams in its literal runs, which gives candidates to be rechecked. */
+
+class trigram_index
+{
+	bitmap_index postings;
+	int max_length;
+
+	void split(const char *str, std::vector<std::string> &grams);
+
+public:
+	/* create/load a trigram index of strings no longer than max_length
+	 * If root_page_id = 0, create a new index. */
+	trigram_index(pager *pg, int root_page_id, int max_length);
+
+	void insert(const char *str, int rid);
+	void erase(const char *str, int rid);
+	/* false if the pattern has no literal run of 3 or more characters, or
+	 * has regex characters which strlike passes through */
+	bool search(const char *pattern, rid_bitmap &rids);
+	static bool searchable(const char *pattern);
+	void flush() { postings.flush(); }
+
+	int get_root_page_id() { return postings.get_root_page_id(); }
+};
+
+#endif
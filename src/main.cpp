@@ -481,6 +481,17 @@ int main(int argc, char *argv[])
                             free((void*)info);
                             result.type = SQL_RESET;
                         } break;
+                        case SQL_LOAD: {
+                            printf("execute_load\n");
+                            load_info_t *load_info = (load_info_t*)result.param;
+                            dbms::get_instance()->load_rows(load_info, iter->connection);
+                            free(load_info->table);
+                            free(load_info->path);
+                            free(load_info->delimiter);
+                            free_linked_list<column_ref_t>(load_info->columns, free_column_ref);
+                            free((void*)load_info);
+                            result.type = SQL_RESET;
+                        } break;
                         case SQL_SELECT: {
                             printf("execute_select\n");
                             select_info_t *select_info = (select_info_t*)result.param;
@@ -496,6 +507,12 @@ int main(int argc, char *argv[])
                                 expression::free_exprnode(data->cond);
                                 free(data);
                             });	
+                            if(select_info->into) {
+                                free(select_info->into->path);
+                                free(select_info->into->delimiter);
+                                free(select_info->into->format);
+                                free(select_info->into);
+                            }
                             free((void*)select_info);
                             result.type = SQL_RESET;
                         } break;
@@ -504,9 +521,12 @@ int main(int argc, char *argv[])
                             update_info_t *update_info = (update_info_t*)result.param;
                             dbms::get_instance()->update_rows(update_info, iter->connection);
                             free(update_info->table);
-                            free_column_ref(update_info->column_ref);
+                            free_linked_list<update_item_t>(update_info->items, [](update_item_t *item) {
+                                free_column_ref(item->column_ref);
+                                expression::free_exprnode(item->value);
+                                free(item);
+                            } );
                             expression::free_exprnode(update_info->where);
-                            expression::free_exprnode(update_info->value);
                             free((void*)update_info);
                             result.type = SQL_RESET;
                         } break;
@@ -521,13 +541,12 @@ int main(int argc, char *argv[])
                         } break;
                         case SQL_CREATE_INDEX: {
                             printf("execute_create_index\n");
-                            std::string tAc((char*)result.param);
-                            std::cout << tAc << std::endl;
-                            std::vector< std::string > items = CppStringPlus::Split(tAc, '$');
-                            std::string table_name = items.front();
-                            items.erase(items.begin());
-                            std::string col_name = items.front();
-                            dbms::get_instance()->create_index(table_name.c_str(), col_name.c_str(), iter->connection);
+                            index_info_t *index_info = (index_info_t*)result.param;
+                            dbms::get_instance()->create_index(index_info, iter->connection);
+                            free(index_info->table);
+                            free_linked_list<column_ref_t>(index_info->columns, free_column_ref);
+                            free_linked_list<column_ref_t>(index_info->includes, free_column_ref);
+                            free((void*)index_info);
                             result.type = SQL_RESET;
                         } break;
                         default:
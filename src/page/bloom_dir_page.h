@@ -0,0 +1,28 @@
+#ifndef __TRIVIALDB_BLOOM_DIR_PAGE__
+#define __TRIVIALDB_BLOOM_DIR_PAGE__
+
+#include "page_defs.h"
+#include "pager.h"
+
+/*    Root page of bloom filter
+ *  | header | bit pages |
+ */
+class bloom_dir_page : public general_page
+{
+public:
+	using general_page::general_page;
+	PAGE_FIELD_REF(magic,    uint16_t, 0);   // page type
+	PAGE_FIELD_REF(page_num, uint16_t, 2);   // number of bit pages
+	PAGE_FIELD_REF(keys,     int,      4);   // keys added since built
+	PAGE_FIELD_PTR(pages,    int,      16);
+	static constexpr int header_size() { return 16; }
+
+	void init()
+	{
+		magic_ref() = PAGE_BLOOM;
+		page_num_ref() = 0;
+		keys_ref() = 0;
+	}
+};
+
+#endif
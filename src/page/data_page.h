@@ -25,6 +25,14 @@ public:
 			*reinterpret_cast<data_page*>(&ret.second)
 		};
 	}
+
+	std::pair<int, data_page> append_page(int cur_id)
+	{
+		auto ret = variant_page::append_page(cur_id);
+		return { ret.first,
+			*reinterpret_cast<data_page*>(&ret.second)
+		};
+	}
 };
 
 #endif
@@ -40,6 +40,8 @@ public:
 	bool insert(int pos, const T& key, int child);
 	void erase(int pos);
 	std::pair<int, fixed_page> split(int cur_id);
+	// link a new empty page after this one
+	std::pair<int, fixed_page> append_page(int cur_id);
 	bool merge(fixed_page page, int cur_id);
 	void move_from(fixed_page page, int src_pos, int dest_pos);
 };
@@ -108,11 +110,8 @@ void fixed_page<T>::erase(int pos)
 }
 
 template<typename T>
-std::pair<int, fixed_page<T>> fixed_page<T>::split(int cur_id)
+std::pair<int, fixed_page<T>> fixed_page<T>::append_page(int cur_id)
 {
-	if(size() < PAGE_BLOCK_MIN_NUM)
-		return { 0, { nullptr, nullptr } };
-
 	int page_id = pg->new_page();
 	if(!page_id) return { 0, { nullptr, nullptr } };
 	fixed_page upper_page { pg->read_for_write(page_id), pg };
@@ -128,6 +127,19 @@ std::pair<int, fixed_page<T>> fixed_page<T>::split(int cur_id)
 	upper_page.next_page_ref() = next_page();
 	upper_page.prev_page_ref() = cur_id;
 	next_page_ref() = page_id;
+	return { page_id, upper_page };
+}
+
+template<typename T>
+std::pair<int, fixed_page<T>> fixed_page<T>::split(int cur_id)
+{
+	if(size() < PAGE_BLOCK_MIN_NUM)
+		return { 0, { nullptr, nullptr } };
+
+	auto upper = append_page(cur_id);
+	int page_id = upper.first;
+	if(!page_id) return { 0, { nullptr, nullptr } };
+	fixed_page upper_page = upper.second;
 
 	int lower_size = size() >> 1;
 	int upper_size = size() - lower_size;
@@ -164,7 +176,7 @@ bool fixed_page<T>::merge(fixed_page page, int cur_id)
 	}
 
 	std::memcpy(children() + size(), page.children(), 4 * page.size());
-	std::memmove(begin() - page.size() * field_size(), begin(), field_size() * page.size());
+	std::memmove(begin() - page.size() * field_size(), begin(), field_size() * size());
 	std::memcpy(end() - page.size() * field_size(), page.begin(), field_size() * page.size());
 	size_ref() += page.size();
 
@@ -0,0 +1,45 @@
+#ifndef __TRIVIALDB_HASH_DIR_PAGE__
+#define __TRIVIALDB_HASH_DIR_PAGE__
+
+#include <cassert>
+#include "page_defs.h"
+#include "pager.h"
+
+/*    Directory page of extendible hash index
+ *  | header | bucket pages | local depth of buckets |
+ */
+class hash_dir_page : public general_page
+{
+public:
+	using general_page::general_page;
+	PAGE_FIELD_REF(magic,        uint16_t, 0);   // page type
+	PAGE_FIELD_REF(global_depth, uint16_t, 2);
+	PAGE_FIELD_PTR(buckets,      int,      16);
+	PAGE_FIELD_PTR(local_depth,  uint8_t,  16 + HASH_DIR_MAX_SIZE * 4);
+	static constexpr int header_size() { return 16; }
+	int size() { return 1 << global_depth(); }
+
+	void init(int bucket_pid)
+	{
+		magic_ref() = PAGE_HASH_DIR;
+		global_depth_ref() = 0;
+		buckets()[0] = bucket_pid;
+		local_depth()[0] = 0;
+	}
+
+	// double the directory
+	void expand()
+	{
+		assert(global_depth() < HASH_MAX_GLOBAL_DEPTH);
+		int n = size();
+		for(int i = 0; i != n; ++i)
+		{
+			buckets()[i + n] = buckets()[i];
+			local_depth()[i + n] = local_depth()[i];
+		}
+
+		++global_depth_ref();
+	}
+};
+
+#endif
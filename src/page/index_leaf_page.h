@@ -22,6 +22,14 @@ public:
 			*reinterpret_cast<index_leaf_page*>(&pw.second)
 		};
 	}
+
+	std::pair<int, index_leaf_page> append_page(int cur_id)
+	{
+		auto pw = fixed_page<T>::append_page(cur_id);
+		return { pw.first,
+			*reinterpret_cast<index_leaf_page*>(&pw.second)
+		};
+	}
 };
 
 #endif
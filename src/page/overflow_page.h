@@ -13,8 +13,10 @@ public:
 	PAGE_FIELD_REF(magic, uint16_t, 0);
 	PAGE_FIELD_REF(size,  uint16_t, 2);  // number of bytes of data in this page
 	PAGE_FIELD_REF(next,  int,      4);
-	PAGE_FIELD_PTR(block, char,     8);
-	static constexpr int header_size() { return 8; }
+	// pages from this one on in the chain, whose ids are consecutive
+	PAGE_FIELD_REF(run,   int,      8);
+	PAGE_FIELD_PTR(block, char,     12);
+	static constexpr int header_size() { return 12; }
 	static constexpr int block_size()  { return PAGE_SIZE - header_size(); }
 
 	void init()
@@ -22,6 +24,7 @@ public:
 		magic_ref() = PAGE_OVERFLOW;
 		size_ref()  = 0;
 		next_ref()  = 0;
+		run_ref()   = 1;
 	}
 };
 
@@ -7,9 +7,15 @@
 
 class pager : public page_file
 {
+	// defragments of variant pages to make room, since the file is opened
+	int defragments = 0;
+
 public:
 	using page_file::page_file;
 
+	void count_defragment() { ++defragments; }
+	int get_defragment_count() const { return defragments; }
+
 	void free_overflow_page(int page_id, bool recursive = true)
 	{
 		auto ov_page = overflow_page(read_for_write(page_id), this);
@@ -24,8 +24,7 @@ void variant_page::erase(int pos, bool follow_ov_page)
 
 	uint16_t* slots_ptr = slots();
 	uint16_t slot = slots_ptr[pos];
-	for(int i = pos, s = size(); i < s; ++i)
-		slots_ptr[i] = slots_ptr[i + 1];
+	std::memmove(slots_ptr + pos, slots_ptr + pos + 1, (size() - pos - 1) * 2);
 
 	block_header *header = (block_header*)(buf + slot);
 	if(header->ov_page && follow_ov_page)
@@ -38,15 +37,47 @@ void variant_page::erase(int pos, bool follow_ov_page)
 
 void variant_page::set_freeblock(int offset)
 {
-	block_header *header = (block_header*)(buf + offset);
+	int blk_size = LOAD_BLK(offset)->size;
 	if(offset + bottom_used() == PAGE_SIZE)
 	{
-		bottom_used_ref() -= header->size;
-	} else {
-		free_block_header *fb_header = LOAD_FREEBLK(offset);
-		fb_header->size = header->size;
-		fb_header->next = free_block();
+		// the lowest block goes back to the unallocated space, and so
+		// does the free block next to it, which is the first one
+		bottom_used_ref() -= blk_size;
+		if(free_block() && free_block() + bottom_used() == PAGE_SIZE)
+		{
+			auto fb_header = LOAD_FREEBLK(free_block());
+			bottom_used_ref() -= fb_header->size;
+			free_block_ref() = fb_header->next;
+		}
+
+		return;
+	}
+
+	// free blocks are kept in the order of offsets, adjacent ones merged
+	int prev = 0, next = free_block();
+	while(next && next < offset)
+	{
+		prev = next;
+		next = LOAD_FREEBLK(next)->next;
+	}
+
+	free_block_header *fb_header = LOAD_FREEBLK(offset);
+	fb_header->size = blk_size;
+	fb_header->next = next;
+	if(next && offset + blk_size == next)
+	{
+		fb_header->size += LOAD_FREEBLK(next)->size;
+		fb_header->next = LOAD_FREEBLK(next)->next;
+	}
+
+	if(!prev)
+	{
 		free_block_ref() = offset;
+	} else if(prev + LOAD_FREEBLK(prev)->size == offset) {
+		LOAD_FREEBLK(prev)->size += fb_header->size;
+		LOAD_FREEBLK(prev)->next = fb_header->next;
+	} else {
+		LOAD_FREEBLK(prev)->next = offset;
 	}
 }
 
@@ -61,8 +92,7 @@ bool variant_page::insert(int pos, const char *data, int data_size)
 
 	// set slot
 	uint16_t *slots_ptr = slots();
-	for(int i = size(); i > pos; --i)
-		slots_ptr[i] = slots_ptr[i - 1];
+	std::memmove(slots_ptr + pos + 1, slots_ptr + pos, (size() - pos) * 2);
 	slots_ptr[pos] = dest - buf;
 	
 	// set data
@@ -78,31 +108,21 @@ bool variant_page::insert(int pos, const char *data, int data_size)
 	{
 		header->ov_page = 0;
 	} else {
-		auto create_and_copy = [&](const char *src, int size) {
-			int pid = pg->new_page();
-			overflow_page page = overflow_page(pg->read_for_write(pid), pg);
-			page.init();
-			page.size_ref() = size;
-			std::memcpy(page.block(), src, size);
-			return std::make_pair(pid, page);
-		};
-
 		data += copied_size;
 		int remain = data_size - copied_size;
-		int to_copy = std::min(overflow_page::block_size(), remain);
-
-		auto ret = create_and_copy(data, to_copy);
-		overflow_page ov_page = ret.second;
-		data   += to_copy;
-		remain -= to_copy;
-		header->ov_page = ret.first;
+		int num = (remain + overflow_page::block_size() - 1) / overflow_page::block_size();
+		int pid = pg->new_pages(num);
+		header->ov_page = pid;
 
-		while(remain > 0)
+		for(int i = 0; i != num; ++i)
 		{
-			to_copy = std::min(overflow_page::block_size(), remain);
-			auto ret = create_and_copy(data, to_copy);
-			ov_page.next_ref() = ret.first;
-			ov_page = ret.second;
+			int to_copy = std::min(overflow_page::block_size(), remain);
+			overflow_page page = overflow_page(pg->read_for_write(pid + i), pg);
+			page.init();
+			page.size_ref() = to_copy;
+			page.next_ref() = i + 1 != num ? pid + i + 1 : 0;
+			page.run_ref() = num - i;
+			std::memcpy(page.block(), data, to_copy);
 			data   += to_copy;
 			remain -= to_copy;
 		}
@@ -111,10 +131,8 @@ bool variant_page::insert(int pos, const char *data, int data_size)
 	return true;
 }
 
-std::pair<int, variant_page> variant_page::split(int cur_id)
+std::pair<int, variant_page> variant_page::append_page(int cur_id)
 {
-	if(size() < PAGE_BLOCK_MIN_NUM)
-		return { 0, { nullptr, nullptr } };
 	int page_id = pg->new_page();
 	if(!page_id) return { 0, { nullptr, nullptr } };
 	variant_page upper_page { pg->read_for_write(page_id), pg };
@@ -130,6 +148,17 @@ std::pair<int, variant_page> variant_page::split(int cur_id)
 	upper_page.next_page_ref() = next_page();
 	upper_page.prev_page_ref() = cur_id;
 	next_page_ref() = page_id;
+	return { page_id, upper_page };
+}
+
+std::pair<int, variant_page> variant_page::split(int cur_id)
+{
+	if(size() < PAGE_BLOCK_MIN_NUM)
+		return { 0, { nullptr, nullptr } };
+	auto upper = append_page(cur_id);
+	int page_id = upper.first;
+	if(!page_id) return { 0, { nullptr, nullptr } };
+	variant_page upper_page = upper.second;
 
 	int to_move = used_size() / 2, moved = 0;
 	char *dest_addr = upper_page.buf + PAGE_SIZE;
@@ -151,7 +180,6 @@ std::pair<int, variant_page> variant_page::split(int cur_id)
 		++upper_page.size_ref();
 		free_size_ref() += size_req;
 		upper_page.free_size_ref() -= size_req;
-		set_freeblock(slots()[i]);
 
 		to_move  -= size_req;
 		moved += size_req;
@@ -159,6 +187,8 @@ std::pair<int, variant_page> variant_page::split(int cur_id)
 
 	std::reverse(upper_page.slots(), upper_page.slots() + upper_page.size());
 	upper_page.bottom_used_ref() = moved;
+	// the blocks moved are scattered, so the rest is compacted at once
+	defragment();
 
 	assert(size() >= PAGE_BLOCK_MIN_NUM / 2);
 	assert(upper_page.size() >= PAGE_BLOCK_MIN_NUM / 2);
@@ -205,38 +235,53 @@ char* variant_page::allocate(int sz)
 	if(free_size() < sz + 2) return nullptr;  // no space for data
 
 	int unallocated = PAGE_SIZE - (header_size() + size() * 2 + bottom_used());
-	auto free_blk = LOAD_FREEBLK(free_block());
-
-	if(unallocated < 2 && free_size() - 2 >= sz)
+	if(unallocated < 2)
 	{
+		// no space for the slot
+		pg->count_defragment();
 		defragment();
 		return allocate(sz);
 	}
 
-	if(free_block() && free_blk->size >= sz)
+	// the smallest free block large enough
+	int best = 0, best_prev = 0;
+	for(int prev = 0, off = free_block(); off; prev = off, off = LOAD_FREEBLK(off)->next)
 	{
-		char *addr = buf + free_block();
-		if(free_blk->size - sz < PAGE_FREE_BLOCK_MIN_SIZE)
+		int blk_size = LOAD_FREEBLK(off)->size;
+		if(blk_size >= sz && (!best || blk_size < LOAD_FREEBLK(best)->size))
 		{
-			free_block_ref() = free_blk->next;
+			best = off;
+			best_prev = prev;
+			if(blk_size == sz) break;
+		}
+	}
+
+	if(best)
+	{
+		free_block_header free_blk = *LOAD_FREEBLK(best);
+		uint16_t &link = best_prev ? LOAD_FREEBLK(best_prev)->next : free_block_ref();
+		if(free_blk.size - sz < PAGE_FREE_BLOCK_MIN_SIZE)
+		{
+			link = free_blk.next;
 		} else {
-			auto free_blk_new = LOAD_FREEBLK(free_block() + sz);
-			free_blk_new->size = free_blk->size - sz;
-			free_blk_new->next = free_blk->next;
-			free_block_ref() += sz;
+			auto free_blk_new = LOAD_FREEBLK(best + sz);
+			free_blk_new->size = free_blk.size - sz;
+			free_blk_new->next = free_blk.next;
+			link = best + sz;
 		}
 
 		free_size_ref() -= sz;
-		return addr;
+		return buf + best;
 	} else if(unallocated - 2 >= sz) {
 		// minus one slot size for this item
 		bottom_used_ref() += sz;
 		free_size_ref() -= sz;
 		return buf + PAGE_SIZE - bottom_used();
-	} else if(free_size() - 2 >= sz) {
+	} else {
+		pg->count_defragment();
 		defragment();
 		return allocate(sz);
-	} else return nullptr;
+	}
 }
 
 void variant_page::defragment()
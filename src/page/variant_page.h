@@ -11,7 +11,12 @@
  * then part of it will be stored in overflow pages and the first
  * PAGE_OV_KEEP_SIZE will stay in the data page. If S <= PAGE_BLOCK_MAX_SIZE,
  * all the data will be stored in the data page.
- * */
+ * The overflow pages of an item are a run of pages with consecutive ids,
+ * all full but the last, so that an offset in the item is found without
+ * reading the pages before it.
+ * Free blocks in a page are a list in the order of their offsets, where
+ * adjacent blocks are merged, and the smallest one large enough is taken
+ * for a new item. The page is defragmented only when none is. */
 
 class variant_page : public general_page
 {
@@ -49,6 +54,10 @@ public:
 	int used_size() {
 		return PAGE_SIZE - free_size() - size() * 2 - header_size();
 	}
+	// free bytes out of the unallocated space, in free blocks or lost
+	int fragmented_size() {
+		return free_size() - (PAGE_SIZE - header_size() - size() * 2 - bottom_used());
+	}
 
 	bool underflow()
 	{
@@ -75,6 +84,8 @@ public:
 	 * satisfied, 0 is returned. The free_size of the two parts is
 	 * as close as possible. */
 	std::pair<int, variant_page> split(int cur_id);
+	// link a new empty page after this one
+	std::pair<int, variant_page> append_page(int cur_id);
 	bool merge(variant_page page, int cur_id);
 
 	std::pair<block_header, char*> get_block(int id)
@@ -19,7 +19,8 @@ typedef enum {
 typedef enum {
 	FIELD_FLAG_NOTNULL = 1,
 	FIELD_FLAG_UNIQUE  = 2,
-	FIELD_FLAG_PRIMARY = 4
+	FIELD_FLAG_PRIMARY = 4,
+	FIELD_FLAG_DICTIONARY = 8
 } field_flag_t;
 
 typedef enum {
@@ -29,6 +30,13 @@ typedef enum {
 	TABLE_CONSTRAINT_CHECK
 } table_constraint_type_t;
 
+typedef enum {
+	INDEX_TYPE_BTREE,
+	INDEX_TYPE_HASH,
+	INDEX_TYPE_BITMAP,
+	INDEX_TYPE_TRIGRAM
+} index_type_t;
+
 typedef enum {
 	TABLE_JOIN_NONE,
 } table_join_type_t;
@@ -106,6 +114,11 @@ typedef struct insert_info_t {
 	linked_list_t *columns, *values;
 } insert_info_t;
 
+typedef struct load_info_t {
+	char *table, *path, *delimiter;
+	linked_list_t *columns;
+} load_info_t;
+
 typedef struct expr_node_t {
 	union {
 		int    val_i;
@@ -132,17 +145,33 @@ typedef struct delete_info_t {
 	expr_node_t *where;
 } delete_info_t;
 
+typedef struct update_item_t {
+	column_ref_t *column_ref;
+	expr_node_t *value;
+} update_item_t;
+
 typedef struct update_info_t {
 	char *table;
-	column_ref_t *column_ref;
-	expr_node_t *where, *value;
+	linked_list_t *items;
+	expr_node_t *where;
 } update_info_t;
 
+typedef struct export_info_t {
+	char *path, *delimiter, *format;
+} export_info_t;
+
 typedef struct select_info_t {
 	linked_list_t *tables, *exprs;
 	expr_node_t *where;
+	export_info_t *into;
 } select_info_t;
 
+typedef struct index_info_t {
+	char *table;
+	linked_list_t *columns, *includes;
+	int type;
+} index_info_t;
+
 typedef struct table_join_info_t {
 	table_join_type_t join_type;
 	char *table, *join_table, *alias;
@@ -158,6 +187,7 @@ typedef enum {
 	SQL_DROP_TABLE,
 	SQL_SHOW_TABLE,
 	SQL_INSERT,
+	SQL_LOAD,
 	SQL_SELECT,
 	SQL_UPDATE,
 	SQL_DELETE,
@@ -117,6 +117,12 @@ void parser_insert(const insert_info_t *insert_info)
 	// free((void*)insert_info);
 }
 
+void parser_load(const load_info_t *load_info)
+{
+	result.type = SQL_LOAD;
+	result.param = (void*)load_info;
+}
+
 void parser_delete(const delete_info_t *delete_info)
 {
 	result.type = SQL_DELETE;
@@ -156,21 +162,21 @@ void parser_update(const update_info_t *update_info)
 
 	// dbms::get_instance()->update_rows(update_info);
 	// free(update_info->table);
-	// free_column_ref(update_info->column_ref);
+	// free_linked_list<update_item_t>(update_info->items, ...);
 	// expression::free_exprnode(update_info->where);
-	// expression::free_exprnode(update_info->value);
 	// free((void*)update_info);
 }
 
-void parser_create_index(const char *table_name, const char *col_name)
+void parser_create_index(const index_info_t *index_info)
 {
-	std::string param = std::string(table_name) + "$" + std::string(col_name);
 	result.type = SQL_CREATE_INDEX;
-	result.param = (void *)param.c_str();
-	
-	// dbms::get_instance()->create_index(table_name, col_name);
-	// free((char*)table_name);
-	// free((char*)col_name);
+	result.param = (void *)index_info;
+
+	// dbms::get_instance()->create_index(index_info);
+	// free(index_info->table);
+	// free(index_info->column);
+	// free_linked_list<column_ref_t>(index_info->includes, free_column_ref);
+	// free((void*)index_info);
 }
 
 void parser_drop_index(const char *table_name, const char *col_name)
@@ -17,10 +17,11 @@ void parser_create_table(const table_def_t *table);
 void parser_drop_table(const char *table_name);
 void parser_show_table(const char *table_name);
 void parser_insert(const insert_info_t *insert_info);
+void parser_load(const load_info_t *load_info);
 void parser_delete(const delete_info_t *delete_info);
 void parser_select(const select_info_t *select_info);
 void parser_update(const update_info_t *update_info);
-void parser_create_index(const char *table_name, const char *col_name);
+void parser_create_index(const index_info_t *index_info);
 void parser_drop_index(const char *table_name, const char *col_name);
 void parser_switch_output(const char *output_filename);
 void parser_quit();
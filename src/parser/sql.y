@@ -27,9 +27,13 @@ void yyerror(const char *s);
 	struct table_constraint_t *constraint;
 	struct insert_info_t      *insert_info;
 	struct update_info_t      *update_info;
+	struct update_item_t      *update_item;
 	struct delete_info_t      *delete_info;
 	struct select_info_t      *select_info;
 	struct table_join_info_t  *join_info;
+	struct index_info_t       *index_info;
+	struct load_info_t        *load_info;
+	struct export_info_t      *export_info;
 	struct expr_node_t        *expr;
 }
 
@@ -38,9 +42,10 @@ void yyerror(const char *s);
 %token INTEGER DOUBLE FLOAT CHAR VARCHAR DATE
 %token INTO FROM WHERE VALUES JOIN INNER OUTER
 %token LEFT RIGHT FULL ASC DESC ORDER BY IN ON AS
-%token DISTINCT GROUP USING INDEX TABLE DATABASE
+%token DISTINCT GROUP USING HASH BITMAP TRIGRAM INDEX INCLUDE TABLE DATABASE
 %token DEFAULT UNIQUE PRIMARY FOREIGN REFERENCES CHECK KEY OUTPUT
 %token USE CREATE DROP SELECT INSERT UPDATE DELETE SHOW SET EXIT
+%token LOAD DATA INFILE FIELDS TERMINATED OUTFILE FORMAT DICTIONARY
 
 %token IDENTIFIER
 %token DATE_LITERAL
@@ -61,17 +66,24 @@ void yyerror(const char *s);
 %type <table_def> create_table_stmt
 %type <column_ref> column_ref
 %type <constraint> table_extra_option
-%type <list> column_list expr_list insert_values literal_list
+%type <list> column_list expr_list insert_values literal_list index_include
 %type <list> table_extra_options table_extra_option_list
 %type <insert_info> insert_stmt insert_columns
 %type <update_info> update_stmt
+%type <update_item> update_item
+%type <list> update_items
 %type <delete_info> delete_stmt
 %type <select_info> select_stmt
 %type <expr> expr factor term condition cond_term where_clause literal literal_list_expr
 %type <expr> aggregate_expr aggregate_term select_expr default_expr
-%type <val_i> logical_op compare_op aggregate_op
+%type <val_i> logical_op compare_op aggregate_op index_type
 %type <list> select_expr_list select_expr_list_s table_refs
 %type <join_info> table_item
+%type <index_info> create_index_stmt
+%type <load_info> load_stmt
+%type <val_s> load_fields
+%type <list> load_columns
+%type <export_info> export_format
 
 %start sql_stmts
 
@@ -89,12 +101,18 @@ sql_stmt   :  create_table_stmt ';'    { parser_create_table($1); }
 		   |  show_table_stmt ';'      { parser_show_table($1); }
 		   |  drop_table_stmt ';'      { parser_drop_table($1); }
 		   |  insert_stmt ';'          { parser_insert($1); }
+		   |  load_stmt ';'            { parser_load($1); }
 		   |  update_stmt ';'          { parser_update($1); }
 		   |  delete_stmt ';'          { parser_delete($1); }
 		   |  select_stmt ';'          { parser_select($1); }
+		   |  select_stmt INTO OUTFILE STRING_LITERAL export_format ';' {
+				$1->into = $5;
+				$1->into->path = $4;
+				parser_select($1);
+			}
 		   |  EXIT ';'                 { parser_quit(); exit(0); }
 		   |  SET OUTPUT '=' STRING_LITERAL ';'  { parser_switch_output($4); }
-		   |  CREATE INDEX table_name '(' IDENTIFIER ')' ';' { parser_create_index($3, $5); }
+		   |  create_index_stmt ';'    { parser_create_index($1); }
 		   |  DROP   INDEX table_name '(' IDENTIFIER ')' ';' { parser_drop_index($3, $5); }
 		   ;
 
@@ -112,6 +130,30 @@ drop_database_stmt   : DROP DATABASE database_name     { $$ = $3; };
 show_database_stmt   : SHOW DATABASE database_name     { $$ = $3; };
 drop_table_stmt      : DROP TABLE table_name           { $$ = $3; };
 show_table_stmt      : SHOW TABLE table_name           { $$ = $3; };
+create_index_stmt    : CREATE INDEX table_name '(' column_list ')' index_include index_type {
+					 	$$ = (index_info_t*)calloc(1, sizeof(index_info_t));
+						$$->table    = $3;
+						$$->columns  = $5;
+						$$->includes = $7;
+						$$->type     = $8;
+					 }
+					 | CREATE BITMAP INDEX table_name '(' column_list ')' {
+					 	$$ = (index_info_t*)calloc(1, sizeof(index_info_t));
+						$$->table    = $4;
+						$$->columns  = $6;
+						$$->type     = INDEX_TYPE_BITMAP;
+					 }
+					 ;
+
+index_include        : INCLUDE '(' column_list ')'  { $$ = $3; }
+					 | /* empty */                  { $$ = NULL; }
+					 ;
+
+index_type           : USING HASH                   { $$ = INDEX_TYPE_HASH; }
+					 | USING TRIGRAM                { $$ = INDEX_TYPE_TRIGRAM; }
+					 | /* empty */                  { $$ = INDEX_TYPE_BTREE; }
+					 ;
+
 insert_stmt          : INSERT INTO insert_columns VALUES insert_values {
 					 	$$ = $3;
 						$$->values = $5;
@@ -144,6 +186,23 @@ insert_columns       : table_name {
 					 }
 					 ;
 
+load_stmt            : LOAD DATA INFILE STRING_LITERAL INTO TABLE table_name load_fields load_columns {
+					 	$$ = (load_info_t*)malloc(sizeof(load_info_t));
+						$$->path      = $4;
+						$$->table     = $7;
+						$$->delimiter = $8;
+						$$->columns   = $9;
+					 }
+					 ;
+
+load_fields          : FIELDS TERMINATED BY STRING_LITERAL  { $$ = $4; }
+					 | /* empty */                          { $$ = NULL; }
+					 ;
+
+load_columns         : '(' column_list ')'  { $$ = $2; }
+					 | /* empty */          { $$ = NULL; }
+					 ;
+
 delete_stmt         : DELETE FROM table_name where_clause {
 					 	$$ = (delete_info_t*)malloc(sizeof(delete_info_t));
 						$$->table = $3;
@@ -151,12 +210,30 @@ delete_stmt         : DELETE FROM table_name where_clause {
 					}
 					;
 
-update_stmt         : UPDATE table_name SET column_ref '=' expr where_clause {
+update_stmt         : UPDATE table_name SET update_items where_clause {
 					 	$$ = (update_info_t*)malloc(sizeof(update_info_t));
 						$$->table = $2;
-						$$->value = $6;
-						$$->where = $7;
-						$$->column_ref = $4;
+						$$->items = $4;
+						$$->where = $5;
+					}
+					;
+
+update_items        : update_items ',' update_item {
+						$$ = (linked_list_t*)malloc(sizeof(linked_list_t));
+						$$->data = $3;
+						$$->next = $1;
+					}
+					| update_item {
+						$$ = (linked_list_t*)malloc(sizeof(linked_list_t));
+						$$->data = $1;
+						$$->next = NULL;
+					}
+					;
+
+update_item         : column_ref '=' expr {
+						$$ = (update_item_t*)malloc(sizeof(update_item_t));
+						$$->column_ref = $1;
+						$$->value = $3;
 					}
 					;
 
@@ -165,6 +242,20 @@ select_stmt         : SELECT select_expr_list_s FROM table_refs where_clause {
 						$$->tables = $4;
 						$$->exprs  = $2;
 						$$->where  = $5;
+						$$->into   = NULL;
+					}
+					;
+
+export_format       : FIELDS TERMINATED BY STRING_LITERAL {
+						$$ = (export_info_t*)calloc(1, sizeof(export_info_t));
+						$$->delimiter = $4;
+					}
+					| FORMAT IDENTIFIER {
+						$$ = (export_info_t*)calloc(1, sizeof(export_info_t));
+						$$->format = $2;
+					}
+					| /* empty */ {
+						$$ = (export_info_t*)calloc(1, sizeof(export_info_t));
 					}
 					;
 
@@ -340,6 +431,7 @@ field_flags : field_flags field_flag  { $$ = $1 | $2; }
 field_flag  : NOT NULL_TOKEN  { $$ = FIELD_FLAG_NOTNULL; }
 			| UNIQUE          { $$ = FIELD_FLAG_UNIQUE; }
 			| PRIMARY KEY     { $$ = FIELD_FLAG_PRIMARY; }
+			| DICTIONARY      { $$ = FIELD_FLAG_DICTIONARY; }
 			;
 
 field_width : '(' INT_LITERAL ')'  { $$ = $2; }
@@ -0,0 +1,262 @@
+#include "bulk_loader.h"
+#include "table.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bulk_loader::bulk_loader(table_manager *tb, const std::vector<int> &cols, char delimiter)
+	: tb(tb), delimiter(delimiter)
+{
+	// the column info is copied, as the table is modified while parsing
+	for(int cid : cols)
+	{
+		this->cols.push_back({
+			tb->get_column_type(cid),
+			tb->get_column_offset(cid),
+			tb->get_column_length(cid),
+			cid
+		});
+	}
+
+	tb->init_temp_record();
+	record_template = tb->get_temp_record();
+}
+
+bool bulk_loader::parse_field(const column_t &col, const char *begin, const char *end, char *record)
+{
+	char *dest = record + col.offset;
+	int len = end - begin;
+	switch(col.type)
+	{
+		case COL_TYPE_INT: {
+			const char *p = begin;
+			bool neg = false;
+			if(p != end && (*p == '-' || *p == '+'))
+				neg = *p++ == '-';
+			if(p == end) return false;
+			int64_t val = 0;
+			for(; p != end; ++p)
+			{
+				if(*p < '0' || *p > '9') return false;
+				val = val * 10 + (*p - '0');
+				if(val > (int64_t)INT32_MAX + 1) return false;
+			}
+
+			if(neg) val = -val;
+			if(val > INT32_MAX) return false;
+			int v = val;
+			std::memcpy(dest, &v, 4);
+			break; }
+		case COL_TYPE_FLOAT: {
+			char buf[64], *p_end;
+			if(len == 0 || len >= (int)sizeof(buf)) return false;
+			std::memcpy(buf, begin, len);
+			buf[len] = 0;
+			float v = std::strtof(buf, &p_end);
+			if(p_end != buf + len) return false;
+			std::memcpy(dest, &v, 4);
+			break; }
+		case COL_TYPE_DATE: {
+			// YYYY-MM-DD, as the date literals
+			static const char pattern[] = "dddd-dd-dd";
+			if(len != 10) return false;
+			for(int i = 0; i != 10; ++i)
+			{
+				bool digit = begin[i] >= '0' && begin[i] <= '9';
+				if(digit != (pattern[i] == 'd') || (!digit && begin[i] != '-'))
+					return false;
+			}
+
+			std::tm tm{};
+			tm.tm_year = std::atoi(begin) - 1900;
+			tm.tm_mon  = std::atoi(begin + 5) - 1;
+			tm.tm_mday = std::atoi(begin + 8);
+			int mday = tm.tm_mday;
+			int v = std::mktime(&tm);
+			if(v == -1 || tm.tm_mday != mday) return false;
+			std::memcpy(dest, &v, 4);
+			break; }
+		case COL_TYPE_VARCHAR:
+			// rejected as by INSERT, rather than cut
+			if(len >= col.length) return false;
+			std::memset(dest, 0, col.length);
+			std::memcpy(dest, begin, len);
+			break;
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+bool bulk_loader::parse_line(const char *begin, const char *end, std::string &record)
+{
+	record = record_template;
+	char *buf = &record[0];
+	int *null_mark = reinterpret_cast<int*>(buf + 4);
+	std::string unquoted;
+
+	const char *p = begin;
+	for(size_t i = 0; i != cols.size(); ++i)
+	{
+		if(i && (p == end || *p++ != delimiter))
+			return false;
+
+		const char *f_begin = p, *f_end;
+		bool is_null = false;
+		if(p != end && *p == '"')
+		{
+			unquoted.clear();
+			for(++p; ; ++p)
+			{
+				if(p == end) return false;
+				if(*p == '"')
+				{
+					if(p + 1 == end || p[1] != '"') break;
+					++p;
+				}
+				unquoted.push_back(*p);
+			}
+
+			++p;
+			f_begin = unquoted.data();
+			f_end = f_begin + unquoted.size();
+		} else {
+			p = f_end = std::find(p, end, delimiter);
+			is_null = f_begin == f_end
+				|| (f_end - f_begin == 2 && f_begin[0] == '\\' && f_begin[1] == 'N');
+		}
+
+		const column_t &col = cols[i];
+		if(is_null)
+		{
+			*null_mark |= 1u << col.cid;
+		} else {
+			if(!parse_field(col, f_begin, f_end, buf))
+				return false;
+			*null_mark &= ~(1u << col.cid);
+		}
+	}
+
+	return p == end;
+}
+
+void bulk_loader::parse(chunk_t *chunk)
+{
+	chunk->failed = 0;
+	for(const char *p = chunk->begin; p != chunk->end; )
+	{
+		const char *eol = (const char*)std::memchr(p, '\n', chunk->end - p);
+		if(!eol) eol = chunk->end;
+		const char *line_end = eol;
+		if(line_end != p && line_end[-1] == '\r')
+			--line_end;
+
+		if(line_end != p)
+		{
+			chunk->records.emplace_back();
+			if(!parse_line(p, line_end, chunk->records.back()))
+			{
+				chunk->records.pop_back();
+				++chunk->failed;
+			}
+		}
+
+		p = eol == chunk->end ? eol : eol + 1;
+	}
+}
+
+void bulk_loader::split_round(const char *&pos, const char *end, int threads, std::vector<chunk_t> &chunks)
+{
+	chunks.clear();
+	for(int i = 0; i != threads && pos != end; ++i)
+	{
+		chunk_t chunk;
+		chunk.begin = pos;
+		if(end - pos <= LOAD_CHUNK_SIZE)
+		{
+			pos = end;
+		} else {
+			pos += LOAD_CHUNK_SIZE;
+			const char *eol = (const char*)std::memchr(pos, '\n', end - pos);
+			pos = eol ? eol + 1 : end;
+		}
+
+		chunk.end = pos;
+		chunks.push_back(std::move(chunk));
+	}
+}
+
+void bulk_loader::parse_round(std::vector<chunk_t> &chunks)
+{
+	if(chunks.empty()) return;
+	std::vector<std::thread> workers;
+	for(size_t i = 1; i < chunks.size(); ++i)
+		workers.emplace_back(&bulk_loader::parse, this, &chunks[i]);
+	parse(&chunks[0]);
+	for(std::thread &t : workers)
+		t.join();
+}
+
+bool bulk_loader::load(const char *path, int *count_succ, int *count_fail)
+{
+	*count_succ = *count_fail = 0;
+	int fd = ::open(path, O_RDONLY);
+	if(fd < 0) return false;
+
+	struct stat st;
+	if(::fstat(fd, &st) != 0)
+	{
+		::close(fd);
+		return false;
+	}
+
+	size_t size = st.st_size;
+	void *addr = nullptr;
+	if(size)
+	{
+		addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(addr == MAP_FAILED)
+		{
+			::close(fd);
+			return false;
+		}
+
+		::madvise(addr, size, MADV_SEQUENTIAL);
+	}
+
+	::close(fd);
+
+	int threads = std::thread::hardware_concurrency();
+	threads = std::max(1, std::min(threads, LOAD_MAX_THREADS));
+
+	const char *pos = (const char*)addr, *end = pos + size;
+	std::vector<chunk_t> cur, next;
+	split_round(pos, end, threads, cur);
+	parse_round(cur);
+	while(!cur.empty())
+	{
+		// parse the next round while inserting this one
+		split_round(pos, end, threads, next);
+		std::thread parser(&bulk_loader::parse_round, this, std::ref(next));
+		for(chunk_t &chunk : cur)
+		{
+			int succ = tb->insert_records(chunk.records);
+			*count_succ += succ;
+			*count_fail += chunk.failed + chunk.records.size() - succ;
+		}
+
+		parser.join();
+		cur.swap(next);
+	}
+
+	if(addr) ::munmap(addr, size);
+	return true;
+}
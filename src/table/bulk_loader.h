@@ -0,0 +1,50 @@
+#ifndef __TRIVIALDB_BULK_LOADER__
+#define __TRIVIALDB_BULK_LOADER__
+#include <string>
+#include <vector>
+
+/* Loader of delimited text files (CSV/TSV) into a table.
+ * The file is memory-mapped and cut at line boundaries into chunks, which
+ * are parsed by worker threads straight into the record layout of the
+ * table, without going through the SQL parser or the expression evaluator.
+ * The records of a round of chunks are inserted in a batch, in file
+ * order, while the workers parse the next round.
+ *
+ * One record per line. A field may be enclosed in double quotes, with
+ * `""` standing for a quote, to contain the delimiter. An empty unquoted
+ * field or `\N` is NULL. */
+
+class table_manager;
+class bulk_loader
+{
+	struct column_t
+	{
+		int type, offset, length, cid;
+	};
+
+	struct chunk_t
+	{
+		const char *begin, *end;
+		std::vector<std::string> records;
+		int failed;
+	};
+
+	table_manager *tb;
+	std::vector<column_t> cols;
+	std::string record_template;
+	char delimiter;
+
+	void parse(chunk_t *chunk);
+	bool parse_line(const char *begin, const char *end, std::string &record);
+	bool parse_field(const column_t &col, const char *begin, const char *end, char *record);
+	void parse_round(std::vector<chunk_t> &chunks);
+	void split_round(const char *&pos, const char *end, int threads, std::vector<chunk_t> &chunks);
+
+public:
+	// load the given columns in the field order of each line
+	bulk_loader(table_manager *tb, const std::vector<int> &cols, char delimiter);
+	// return false if the file cannot be read
+	bool load(const char *path, int *count_succ, int *count_fail);
+};
+
+#endif
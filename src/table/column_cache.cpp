@@ -0,0 +1,354 @@
+#include <algorithm>
+#include <cassert>
+#include "column_cache.h"
+#include "../defs.h"
+
+namespace {
+
+typedef column_cache::value_t value_t;
+typedef column_cache::cond_t cond_t;
+typedef column_cache::selection_t selection_t;
+
+int bit_width(uint32_t x)
+{
+	int width = 0;
+	for(; x; x >>= 1) ++width;
+	return width;
+}
+
+int64_t packed_size(int num, int width)
+{
+	return ((int64_t)num * width + 63) / 64 * 8;
+}
+
+void pack(std::vector<uint64_t> &packed, int width, const std::vector<uint32_t> &codes)
+{
+	packed.assign(packed_size(codes.size(), width) / 8, 0);
+	if(!width) return;
+	for(size_t i = 0; i != codes.size(); ++i)
+	{
+		size_t pos = i * width;
+		int off = pos & 63;
+		packed[pos >> 6] |= (uint64_t)codes[i] << off;
+		if(off + width > 64)
+			packed[(pos >> 6) + 1] |= (uint64_t)codes[i] >> (64 - off);
+	}
+}
+
+inline uint32_t unpack(const uint64_t *packed, int width, int i)
+{
+	if(!width) return 0;
+	size_t pos = (size_t)i * width;
+	int off = pos & 63;
+	uint64_t v = packed[pos >> 6] >> off;
+	if(off + width > 64)
+		v |= packed[(pos >> 6) + 1] << (64 - off);
+	return v & ((1ull << width) - 1);
+}
+
+int compare(int type, value_t a, value_t b)
+{
+	if(type == COL_TYPE_FLOAT)
+		return a.f < b.f ? -1 : (a.f > b.f ? 1 : 0);
+	return a.i < b.i ? -1 : (a.i > b.i ? 1 : 0);
+}
+
+bool match(int type, value_t v, const cond_t &cond)
+{
+	int r = compare(type, v, cond.val);
+	switch(cond.op)
+	{
+		case OPERATOR_EQ:  return r == 0;
+		case OPERATOR_LT:  return r < 0;
+		case OPERATOR_LEQ: return r <= 0;
+		case OPERATOR_GT:  return r > 0;
+		case OPERATOR_GEQ: return r >= 0;
+		default: return true;
+	}
+}
+
+// the INT values in [lo, hi] satisfy the condition
+void int_range(const cond_t &cond, int64_t &lo, int64_t &hi)
+{
+	int64_t v = cond.val.i;
+	lo = INT32_MIN;
+	hi = INT32_MAX;
+	switch(cond.op)
+	{
+		case OPERATOR_EQ:  lo = hi = v; break;
+		case OPERATOR_LT:  hi = v - 1; break;
+		case OPERATOR_LEQ: hi = v; break;
+		case OPERATOR_GT:  lo = v + 1; break;
+		case OPERATOR_GEQ: lo = v; break;
+		default: break;
+	}
+}
+
+// clear the selected records for which `pred' is false, 64 at a time
+template<typename Pred>
+void select_by(int size, selection_t &sel, Pred pred)
+{
+	for(int w = 0; w * 64 < size; ++w)
+	{
+		if(!sel[w]) continue;
+		int num = std::min(64, size - w * 64);
+		uint64_t mask = 0;
+		for(int j = 0; j != num; ++j)
+			mask |= (uint64_t)pred(w * 64 + j) << j;
+		sel[w] &= mask;
+	}
+}
+
+void clear_range(selection_t &sel, int begin, int end)
+{
+	while(begin < end)
+	{
+		int off = begin & 63;
+		int num = std::min(64 - off, end - begin);
+		uint64_t mask = num == 64 ? ~0ull : ((1ull << num) - 1) << off;
+		sel[begin >> 6] &= ~mask;
+		begin += num;
+	}
+}
+
+}
+
+column_cache::column_cache(const std::vector<int> &types)
+	: types(types)
+{
+}
+
+bool column_cache::is_stored(int cid)
+{
+	int type = types[cid];
+	return type == COL_TYPE_INT || type == COL_TYPE_FLOAT || type == COL_TYPE_DATE;
+}
+
+bool column_cache::is_hot(int pid)
+{
+	if(COLUMN_CACHE_MAX_PAGES == 0)
+		return false;
+	if(leaves.count(pid))
+		return true;
+	if(++scans[pid] < COLUMN_CACHE_HOT_SCANS)
+		return false;
+
+	scans.erase(pid);
+	if(leaves.size() >= COLUMN_CACHE_MAX_PAGES)
+		leaves.clear();
+	return true;
+}
+
+uint32_t column_cache::get_built(int pid, uint32_t version)
+{
+	auto it = leaves.find(pid);
+	if(it == leaves.end()) return 0;
+	if(it->second.version != version)
+	{
+		leaves.erase(it);
+		return 0;
+	}
+
+	return it->second.built;
+}
+
+void column_cache::build(int pid, uint32_t version, int cid,
+		const std::vector<value_t> &values, const std::vector<uint64_t> &nulls)
+{
+	assert(is_stored(cid));
+	auto it = leaves.find(pid);
+	if(it == leaves.end() || it->second.version != version)
+	{
+		leaf_t &leaf = leaves[pid];
+		leaf.version = version;
+		leaf.size = values.size();
+		leaf.built = 0;
+		leaf.segs.assign(types.size(), segment_t());
+		it = leaves.find(pid);
+	}
+
+	leaf_t &leaf = it->second;
+	assert(leaf.size == (int)values.size());
+	segment_t &seg = leaf.segs[cid];
+
+	// NULL records repeat the previous value, which keeps runs longer
+	std::vector<value_t> vals(values);
+	bool has_null = false;
+	for(int i = 0; i != leaf.size; ++i)
+	{
+		if(!((nulls[i >> 6] >> (i & 63)) & 1))
+			continue;
+		has_null = true;
+		vals[i].i = i ? vals[i - 1].i : 0;
+	}
+
+	encode(seg, types[cid], vals);
+	if(has_null) seg.nulls = nulls;
+	else seg.nulls.clear();
+	leaf.built |= 1u << cid;
+}
+
+void column_cache::encode(segment_t &seg, int type, const std::vector<value_t> &values)
+{
+	int num = values.size();
+	seg.encoding = ENCODING_PLAIN;
+	seg.width = 0;
+	seg.base.i = 0;
+	seg.values.clear();
+	seg.run_ends.clear();
+	seg.packed.clear();
+	if(num == 0) return;
+
+	int runs = 1;
+	for(int i = 1; i != num; ++i)
+		runs += values[i].i != values[i - 1].i;
+
+	// distinct values are told apart by their bits
+	std::vector<int> dict(num);
+	for(int i = 0; i != num; ++i)
+		dict[i] = values[i].i;
+	std::sort(dict.begin(), dict.end());
+	dict.erase(std::unique(dict.begin(), dict.end()), dict.end());
+	int dict_width = bit_width(dict.size() - 1);
+
+	int64_t lo = values[0].i, hi = values[0].i;
+	for(int i = 1; i != num; ++i)
+	{
+		lo = std::min(lo, (int64_t)values[i].i);
+		hi = std::max(hi, (int64_t)values[i].i);
+	}
+
+	int for_width = hi - lo < (1ll << 32) ? bit_width(hi - lo) : 33;
+
+	int64_t best = (int64_t)num * 4;
+	if((int64_t)runs * 6 < best)
+	{
+		best = (int64_t)runs * 6;
+		seg.encoding = ENCODING_RLE;
+	}
+
+	int64_t dict_size = (int64_t)dict.size() * 4 + packed_size(num, dict_width);
+	if(dict_size < best)
+	{
+		best = dict_size;
+		seg.encoding = ENCODING_DICT;
+	}
+
+	if(type != COL_TYPE_FLOAT && for_width <= 32 && 4 + packed_size(num, for_width) < best)
+	{
+		best = 4 + packed_size(num, for_width);
+		seg.encoding = ENCODING_FOR;
+	}
+
+	std::vector<uint32_t> codes;
+	switch(seg.encoding)
+	{
+		case ENCODING_PLAIN:
+			seg.values = values;
+			break;
+		case ENCODING_RLE:
+			for(int i = 0; i != num; ++i)
+			{
+				if(i && values[i].i == values[i - 1].i)
+				{
+					++seg.run_ends.back();
+				} else {
+					seg.values.push_back(values[i]);
+					seg.run_ends.push_back(i + 1);
+				}
+			}
+			break;
+		case ENCODING_DICT:
+			seg.width = dict_width;
+			for(int v : dict)
+			{
+				value_t val;
+				val.i = v;
+				seg.values.push_back(val);
+			}
+
+			for(int i = 0; i != num; ++i)
+				codes.push_back(std::lower_bound(dict.begin(), dict.end(), values[i].i) - dict.begin());
+			pack(seg.packed, seg.width, codes);
+			break;
+		case ENCODING_FOR:
+			seg.width = for_width;
+			seg.base.i = lo;
+			for(int i = 0; i != num; ++i)
+				codes.push_back(values[i].i - lo);
+			pack(seg.packed, seg.width, codes);
+			break;
+	}
+}
+
+void column_cache::select(int pid, const std::vector<cond_t> &conds, selection_t &sel)
+{
+	auto it = leaves.find(pid);
+	assert(it != leaves.end());
+	const leaf_t &leaf = it->second;
+	sel.assign((leaf.size + 63) / 64, ~0ull);
+	if(leaf.size & 63)
+		sel.back() = (1ull << (leaf.size & 63)) - 1;
+
+	for(const cond_t &cond : conds)
+	{
+		assert((leaf.built >> cond.cid) & 1);
+		filter(leaf.segs[cond.cid], types[cond.cid], leaf.size, cond, sel);
+	}
+}
+
+void column_cache::filter(const segment_t &seg, int type, int size,
+		const cond_t &cond, selection_t &sel)
+{
+	const uint64_t *packed = seg.packed.data();
+	int width = seg.width;
+	switch(seg.encoding)
+	{
+		case ENCODING_PLAIN:
+			select_by(size, sel, [&](int i) {
+				return match(type, seg.values[i], cond);
+			} );
+			break;
+		case ENCODING_RLE: {
+			int begin = 0;
+			for(size_t r = 0; r != seg.values.size(); ++r)
+			{
+				if(!match(type, seg.values[r], cond))
+					clear_range(sel, begin, seg.run_ends[r]);
+				begin = seg.run_ends[r];
+			}
+			break;
+		}
+		case ENCODING_DICT: {
+			// the condition is evaluated once for each distinct value
+			std::vector<char> hit(seg.values.size());
+			for(size_t k = 0; k != hit.size(); ++k)
+				hit[k] = match(type, seg.values[k], cond);
+			select_by(size, sel, [&](int i) {
+				return hit[unpack(packed, width, i)];
+			} );
+			break;
+		}
+		case ENCODING_FOR: {
+			// compare the differences with the range shifted by the base
+			int64_t lo, hi;
+			int_range(cond, lo, hi);
+			lo = std::max(lo - seg.base.i, (int64_t)0);
+			hi = std::min(hi - seg.base.i, (int64_t)((1ull << width) - 1));
+			if(lo > hi)
+			{
+				std::fill(sel.begin(), sel.end(), 0);
+				break;
+			}
+
+			uint64_t span = hi - lo;
+			select_by(size, sel, [&](int i) {
+				return (uint64_t)(unpack(packed, width, i) - lo) <= span;
+			} );
+			break;
+		}
+	}
+
+	for(size_t w = 0; w != seg.nulls.size(); ++w)
+		sel[w] &= ~seg.nulls[w];
+}
@@ -0,0 +1,85 @@
+#ifndef __TRIVIALDB_COLUMN_CACHE__
+#define __TRIVIALDB_COLUMN_CACHE__
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "zone_map.h"
+
+/* In-memory scan cache of the data leaves, rebuilt from the records.
+ * The values of an INT, FLOAT or DATE column in a leaf are kept column by
+ * column (PAX) in the order of the records, with the smallest of the
+ * encodings:
+ *
+ *   PLAIN  the values
+ *   RLE    runs of equal values
+ *   DICT   distinct values, and bit-packed codes of the records
+ *   FOR    the smallest value, and bit-packed differences (INT and DATE)
+ *
+ * Scans evaluate `column op value' conditions on the segments a leaf at
+ * a time, and only read the records selected. Segments are built when a
+ * leaf has been scanned COLUMN_CACHE_HOT_SCANS times with conditions, and
+ * dropped when the leaf is written or its version is bumped by splits and
+ * merges. At most COLUMN_CACHE_MAX_PAGES leaves are cached. */
+
+class column_cache
+{
+public:
+	typedef zone_map::value_t value_t;
+	typedef zone_map::cond_t cond_t;
+	// a bit for each record of a leaf
+	typedef std::vector<uint64_t> selection_t;
+
+	enum encoding_t
+	{
+		ENCODING_PLAIN, ENCODING_RLE, ENCODING_DICT, ENCODING_FOR
+	};
+
+	struct segment_t
+	{
+		encoding_t encoding;
+		int width;                      // bits of the packed values
+		value_t base;                   // FOR
+		std::vector<value_t> values;    // PLAIN values, RLE runs, DICT entries
+		std::vector<uint16_t> run_ends; // RLE
+		std::vector<uint64_t> packed;   // DICT codes, FOR differences
+		std::vector<uint64_t> nulls;    // NULL records, empty if none
+	};
+
+private:
+	struct leaf_t
+	{
+		uint32_t version;
+		int size;
+		uint32_t built;  // columns having a segment
+		std::vector<segment_t> segs;
+	};
+
+	std::vector<int> types;
+	std::unordered_map<int, leaf_t> leaves;
+	// scans of the leaves not cached yet
+	std::unordered_map<int, int> scans;
+
+	void encode(segment_t &seg, int type, const std::vector<value_t> &values);
+	void filter(const segment_t &seg, int type, int size,
+			const cond_t &cond, selection_t &sel);
+
+public:
+	explicit column_cache(const std::vector<int> &types);
+
+	bool is_stored(int cid);
+	// count a scan of a leaf, true if it is cached or should be
+	bool is_hot(int pid);
+	// the columns of a leaf having a segment for this version
+	uint32_t get_built(int pid, uint32_t version);
+	// add the segment of a column, the records being NULL in `nulls'
+	void build(int pid, uint32_t version, int cid,
+			const std::vector<value_t> &values, const std::vector<uint64_t> &nulls);
+	/* select the records of a leaf matching all the conditions, whose
+	 * columns have been built */
+	void select(int pid, const std::vector<cond_t> &conds, selection_t &sel);
+	// drop the segments of a leaf after it is written
+	void invalidate(int pid) { leaves.erase(pid); scans.erase(pid); }
+	void clear() { leaves.clear(); scans.clear(); }
+};
+
+#endif
@@ -0,0 +1,41 @@
+#include <cstring>
+#include "dictionary.h"
+#include "record.h"
+#include "../btree/iterator.h"
+
+dictionary::dictionary(pager *pg, int root_page_id)
+	: btr(std::make_shared<int_btree>(pg, root_page_id))
+{
+	if(!root_page_id) return;
+	auto ret = btr->lower_bound(0);
+	btree_iterator<int_btree::leaf_page> it(pg, ret);
+	for(; !it.is_end(); it.next())
+	{
+		int head[2];  // code and length
+		record_manager rm(pg);
+		rm.open(it.get(), false);
+		rm.read(head, sizeof(head));
+		std::string str(head[1], '\0');
+		rm.read(&str[0], head[1]);
+		codes[str] = head[0];
+		strings.push_back(std::move(str));
+	}
+}
+
+int dictionary::encode(const std::string &str)
+{
+	auto it = codes.find(str);
+	if(it != codes.end()) return it->second;
+
+	int code = strings.size();
+	int length = str.size();
+	std::string buf(8, '\0');
+	std::memcpy(&buf[0], &code, 4);
+	std::memcpy(&buf[4], &length, 4);
+	buf += str;
+	btr->insert(code, buf.data(), buf.size());
+
+	strings.push_back(str);
+	codes[str] = code;
+	return code;
+}
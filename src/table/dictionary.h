@@ -0,0 +1,36 @@
+#ifndef __TRIVIALDB_DICTIONARY__
+#define __TRIVIALDB_DICTIONARY__
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "../btree/btree.h"
+
+/* Dictionary of a VARCHAR column declared with DICTIONARY.
+ * The distinct strings of the column get the codes 0, 1, ... in the order
+ * they are first stored, and stored records keep the codes instead of the
+ * strings. The dictionary is a b-tree in the table file from the codes to
+ *   | code | length | bytes |
+ * which is loaded into memory when the table is opened. Strings are never
+ * removed, so codes are stable. */
+
+class dictionary
+{
+	std::shared_ptr<int_btree> btr;
+	// strings are not moved when more are added
+	std::deque<std::string> strings;
+	std::unordered_map<std::string, int> codes;
+
+public:
+	// If root_page_id = 0, create an empty dictionary
+	dictionary(pager *pg, int root_page_id);
+
+	int get_root_page_id() { return btr->get_root_page_id(); }
+	int size() const { return strings.size(); }
+	// the code of a string, which is added if new
+	int encode(const std::string &str);
+	const char *decode(int code) const { return strings[code].c_str(); }
+};
+
+#endif
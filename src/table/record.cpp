@@ -2,6 +2,7 @@
 #include "table.h"
 #include "../page/overflow_page.h"
 #include <cstring>
+#include <algorithm>
 
 void record_manager::open(int pid, int pos, bool dirty)
 {
@@ -10,6 +11,7 @@ void record_manager::open(int pid, int pos, bool dirty)
 	this->cur_pid = pid;
 	this->dirty = dirty;
 	this->offset = 0;
+	this->cur_run = 0;
 
 	if(pid)
 	{
@@ -29,6 +31,7 @@ record_manager& record_manager::seek(int offset)
 	} else {
 		this->cur_pid = pid;
 		this->offset = 0;
+		this->cur_run = 0;
 		data_page<int> page { dirty ? pg->read_for_write(pid) : pg->read(pid), pg };
 		auto block = page.get_block(pos);
 		remain = block.first.size - sizeof(data_page<int>::block_header);
@@ -78,10 +81,19 @@ record_manager& record_manager::forward(int size)
 	cur_buf += size;
 	while(remain <= 0 && next_pid)
 	{
+		// pages of the run before its last one are full
+		int skip = std::min(-remain / overflow_page::block_size(), cur_run - 2);
+		if(skip > 0)
+		{
+			remain += skip * overflow_page::block_size();
+			next_pid = cur_pid + skip + 1;
+		}
+
 		overflow_page page { dirty ? pg->read_for_write(next_pid) : pg->read(next_pid), pg };
 		remain += page.size();
 		cur_buf = page.block() + (page.size() - remain);
 		cur_pid = next_pid;
+		cur_run = page.run();
 		next_pid = page.next();
 	}
 
@@ -11,6 +11,7 @@ class record_manager
 	int pid, pos, cur_pid;
 	char *cur_buf;
 	int remain, next_pid, offset;
+	int cur_run;  // run of the current overflow page, 0 in the data page
 	bool dirty;
 public:
 	record_manager(pager *pg) : pg(pg), pid(0) {}
@@ -18,6 +19,7 @@ public:
 	void open(std::pair<int, int> pw, bool dirty) {
 		open(pw.first, pw.second, dirty);
 	}
+	// pages of a run which are passed over by a seek are not read
 	record_manager& seek(int offset);
 	record_manager& write(const void* data, int size);
 	record_manager& read(void* buf, int size);
@@ -27,6 +29,7 @@ public:
 	std::pair<char*, int> ptr_for_write();
 	std::pair<const char*, int> ptr() { return { cur_buf, remain }; }
 	bool valid() const { return pid != 0; }
+	std::pair<int, int> position() const { return { pid, pos }; }
 };
 
 inline std::pair<char*, int> record_manager::ptr_for_write()
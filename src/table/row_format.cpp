@@ -0,0 +1,151 @@
+#include "row_format.h"
+#include <algorithm>
+#include <cstring>
+
+void row_format::init(const table_header_t *header)
+{
+	this->header = header;
+	fixed_size = 8;  // rid and notnull
+	var_num = 0;
+	int var_size = 0;
+	for(int i = 0; i < header->col_num; ++i)
+	{
+		dicts[i] = nullptr;
+		if(header->col_offset[i] < 8)
+		{
+			// the rid
+			offset[i] = header->col_offset[i];
+		} else if(is_coded(i)) {
+			offset[i] = fixed_size;
+			fixed_size += 4;
+		} else if(header->col_type[i] == COL_TYPE_VARCHAR) {
+			offset[i] = -1;
+			var_index[i] = var_num++;
+			var_size += header->col_length[i];
+		} else {
+			offset[i] = fixed_size;
+			fixed_size += header->col_length[i];
+		}
+	}
+
+	max_size = get_prefix_size() + var_size;
+}
+
+int row_format::get_size(const char *stored) const
+{
+	if(!var_num) return fixed_size;
+	uint16_t end;
+	std::memcpy(&end, stored + fixed_size + (var_num - 1) * 2, 2);
+	return get_prefix_size() + end;
+}
+
+int row_format::get_read_size(uint32_t cols) const
+{
+	int size = 8;
+	for(int i = 0; i < header->col_num; ++i)
+	{
+		if(!(cols & (1u << i)))
+			continue;
+		if(offset[i] < 0)
+			return 0;
+		size = std::max(size, offset[i] + (is_coded(i) ? 4 : header->col_length[i]));
+	}
+
+	return size;
+}
+
+const char *row_format::get_column(const char *stored, int cid) const
+{
+	if(is_coded(cid))
+	{
+		int code;
+		std::memcpy(&code, stored + offset[cid], 4);
+		return dicts[cid]->decode(code);
+	}
+
+	if(offset[cid] >= 0)
+		return stored + offset[cid];
+
+	uint16_t begin = 0;
+	int k = var_index[cid];
+	if(k) std::memcpy(&begin, stored + fixed_size + (k - 1) * 2, 2);
+	return stored + get_prefix_size() + begin;
+}
+
+void row_format::get_var_range(const char *stored, int cid, int &begin, int &end) const
+{
+	uint16_t b = 0, e;
+	int k = var_index[cid];
+	const char *dir = stored + fixed_size;
+	if(k) std::memcpy(&b, dir + (k - 1) * 2, 2);
+	std::memcpy(&e, dir + k * 2, 2);
+	begin = get_prefix_size() + b;
+	end = get_prefix_size() + e;
+}
+
+int row_format::pack(const char *record, const int *codes, char *stored) const
+{
+	std::memcpy(stored, record, 8);
+	int null_mark = ((const int*)record)[1];
+	char *dir = stored + fixed_size;
+	char *bytes = stored + get_prefix_size();
+	uint16_t end = 0;
+	for(int i = 0; i < header->col_num; ++i)
+	{
+		int len = header->col_length[i];
+		const char *col = record + header->col_offset[i];
+		if(is_coded(i))
+		{
+			int code = ((null_mark >> i) & 1) ? -1 : codes[i];
+			std::memcpy(stored + offset[i], &code, 4);
+			continue;
+		}
+
+		if(offset[i] >= 0)
+		{
+			if(offset[i] >= 8)
+				std::memcpy(stored + offset[i], col, len);
+			continue;
+		}
+
+		if(!((null_mark >> i) & 1))
+		{
+			int n = strnlen(col, len - 1);
+			std::memcpy(bytes + end, col, n);
+			bytes[end + n] = 0;
+			end += n + 1;
+		}
+
+		std::memcpy(dir + var_index[i] * 2, &end, 2);
+	}
+
+	return get_prefix_size() + end;
+}
+
+void row_format::unpack(const char *stored, char *record) const
+{
+	std::memcpy(record, stored, 8);
+	int null_mark = ((const int*)stored)[1];
+	for(int i = 0; i < header->col_num; ++i)
+	{
+		int len = header->col_length[i];
+		char *col = record + header->col_offset[i];
+		if(offset[i] >= 0 && !is_coded(i))
+		{
+			if(offset[i] >= 8)
+				std::memcpy(col, stored + offset[i], len);
+			continue;
+		}
+
+		// an empty string for NULL
+		int n = 0;
+		if(!((null_mark >> i) & 1))
+		{
+			const char *str = get_column(stored, i);
+			n = strnlen(str, len - 1);
+			std::memcpy(col, str, n);
+		}
+
+		std::memset(col + n, 0, len - n);
+	}
+}
@@ -0,0 +1,61 @@
+#ifndef __TRIVIALDB_ROW_FORMAT__
+#define __TRIVIALDB_ROW_FORMAT__
+
+#include <stdint.h>
+#include "table_header.h"
+#include "dictionary.h"
+
+/* Records are kept in memory with a fixed layout, each column in a slot
+ * of col_length bytes at col_offset. In the data pages they are stored
+ * without the unused bytes of VARCHAR columns:
+ *
+ *   | rid | notnull | fixed col ... | u16 end ... | VARCHAR bytes ... |
+ *
+ * The fixed columns are in column order. The ends are the offsets of the
+ * end of each VARCHAR column in the bytes following them. A VARCHAR
+ * column keeps its terminating zero, so that it can be read in place,
+ * and a NULL one takes no bytes. VARCHAR columns with a dictionary are
+ * fixed columns of their codes instead, -1 for NULL. */
+
+class row_format
+{
+	const table_header_t *header;
+	// offset of fixed columns in stored records, -1 for VARCHAR columns
+	int offset[MAX_COL_NUM];
+	// order of VARCHAR columns in the directory
+	int var_index[MAX_COL_NUM];
+	int fixed_size, var_num, max_size;
+	dictionary *dicts[MAX_COL_NUM];
+
+	bool is_coded(int cid) const { return (header->flag_dictionary >> cid) & 1; }
+
+public:
+	row_format() : header(nullptr), fixed_size(8), var_num(0), max_size(8) {}
+	void init(const table_header_t *header);
+	void set_dictionary(int cid, dictionary *dict) { dicts[cid] = dict; }
+
+	// stored as in the fixed layout
+	bool is_fixed(int cid) const { return offset[cid] >= 0 && !is_coded(cid); }
+	// offset of a fixed column or a code, -1 for other VARCHAR columns
+	int get_offset(int cid) const { return offset[cid]; }
+	// bytes before the VARCHAR bytes, where the size of a record is known
+	int get_prefix_size() const { return fixed_size + var_num * 2; }
+	int get_max_size() const { return max_size; }
+	// size of a stored record of which the prefix is given
+	int get_size(const char *stored) const;
+	/* bytes of stored records to read for the columns `cols', or 0 if
+	 * the whole records are needed */
+	int get_read_size(uint32_t cols) const;
+
+	// the column of a stored record, which is not NULL
+	const char *get_column(const char *stored, int cid) const;
+	/* bytes [begin, end) of a VARCHAR column without dictionary in a
+	 * stored record of which the prefix is given */
+	void get_var_range(const char *stored, int cid, int &begin, int &end) const;
+	/* return the size of the stored record, where the columns with a
+	 * dictionary are stored as `codes[cid]' */
+	int pack(const char *record, const int *codes, char *stored) const;
+	void unpack(const char *stored, char *record) const;
+};
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef __TRIVIALDB_ROW_VIEW__
+#define __TRIVIALDB_ROW_VIEW__
+
+#include <cstring>
+#include "table_header.h"
+#include "row_format.h"
+#include "../page/pager.h"
+#include "../utils/type_cast.h"
+
+/* A record, either stored (see row_format.h) or in the fixed layout, read
+ * in place. A stored record is either in a data page, which is pinned
+ * while the view is on it, or in a buffer of the table when it spans
+ * overflow pages. */
+
+class row_view
+{
+	const table_header_t *header;
+	const row_format *format;
+	const char *data;
+	bool stored;
+	pager *pg;
+	int pid;
+
+public:
+	row_view() : header(nullptr), format(nullptr), data(nullptr), stored(false), pg(nullptr), pid(0) {}
+	~row_view() { release(); }
+	row_view(const row_view&) = delete;
+	row_view& operator = (const row_view&) = delete;
+
+	void set_format(const table_header_t *header, const row_format *format)
+	{
+		this->header = header;
+		this->format = format;
+	}
+
+	// view the record at `record', which is in page `pid' of `pg' if any
+	void reset(const char *record, bool stored, pager *pg = nullptr, int pid = 0)
+	{
+		if(this->pg != pg || this->pid != pid)
+		{
+			if(pg) pg->pin(pid);
+			if(this->pg) this->pg->unpin(this->pid);
+			this->pg = pg;
+			this->pid = pid;
+		}
+
+		data = record;
+		this->stored = stored;
+	}
+
+	void release()
+	{
+		if(pg) pg->unpin(pid);
+		pg = nullptr;
+		pid = 0;
+		data = nullptr;
+	}
+
+	bool valid() const { return data != nullptr; }
+	bool is_stored() const { return stored; }
+	const char *table_name() const { return header->table_name; }
+	int column_type(int cid) const { return header->col_type[cid]; }
+
+	bool is_null(int cid) const
+	{
+		return (((const int*)data)[1] >> cid) & 1;
+	}
+
+	// nullptr if the column is NULL
+	const char *get_column(int cid) const
+	{
+		if(is_null(cid)) return nullptr;
+		return stored ? format->get_column(data, cid) : data + header->col_offset[cid];
+	}
+
+	// the column visible to expressions, or -1
+	int lookup_column(const char *col_name) const
+	{
+		for(int i = 0; i < header->col_num; ++i)
+		{
+			if(i == header->main_index && header->is_main_index_additional)
+				continue;
+			if(std::strcmp(col_name, header->col_name[i]) == 0)
+				return i;
+		}
+
+		return -1;
+	}
+
+	expression get_expr(int cid) const
+	{
+		return typecast::column_to_expr(
+			const_cast<char*>(get_column(cid)), header->col_type[cid]);
+	}
+};
+
+#endif
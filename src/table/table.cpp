@@ -2,18 +2,23 @@
 #include "../index/index.h"
 #include "../expression/expression.h"
 #include "../utils/type_cast.h"
+#include "../utils/key_encoder.h"
+#include "../utils/hasher.h"
+#include "../algo/search.h"
 #include "../database/dbms.h"
 #include <cstdio>
 #include <cassert>
 #include <cstdio>
 #include <cstring>
 #include <string>
+#include <algorithm>
 
 index_manager::comparer_t get_index_comparer(int type)
 {
 	switch(type)
 	{
 		case COL_TYPE_INT:
+		case COL_TYPE_DATE:
 			return integer_bin_comparer;
 		case COL_TYPE_FLOAT:
 			return float_bin_comparer;
@@ -25,6 +30,23 @@ index_manager::comparer_t get_index_comparer(int type)
 	}
 }
 
+index_manager::hasher_t get_index_hasher(int type)
+{
+	switch(type)
+	{
+		case COL_TYPE_INT:
+		case COL_TYPE_DATE:
+			return integer_bin_hasher;
+		case COL_TYPE_FLOAT:
+			return float_bin_hasher;
+		case COL_TYPE_VARCHAR:
+			return string_hasher;
+		default:
+			assert(0);
+			return string_hasher;
+	}
+}
+
 record_manager table_manager::open_record_from_index_lower_bound(
 	std::pair<int, int> idx_pos, int *rid)
 {
@@ -35,41 +57,226 @@ record_manager table_manager::open_record_from_index_lower_bound(
 	return rm;
 }
 
+void table_manager::cache_record_from_index(int cid, std::pair<int, int> idx_pos, int *rid)
+{
+	assert(indices[cid]);
+	const char *entry = indices[cid]->get_entry(idx_pos);
+	// rebuild a partial record, columns not covered by the index are NULL
+	int null_mark = ((1u << header.col_num) - 1) & ~(1u << header.main_index);
+	((int*)tmp_cache)[0] = index_manager::entry_rid(entry);
+	const char *key = index_manager::entry_key(entry);
+	if(key != nullptr)
+	{
+		null_mark &= ~(1u << cid);
+		std::memcpy(tmp_cache + header.col_offset[cid], key, header.col_length[cid]);
+	}
+
+	uint32_t include = header.index_include[cid];
+	if(include)
+	{
+		const char *payload = indices[cid]->entry_payload(entry);
+		int payload_null_mark = *(const int*)payload;
+		payload += 4;
+		for(int i = 0; i < header.col_num; ++i)
+		{
+			if(!(include & (1u << i)))
+				continue;
+			if(!((payload_null_mark >> i) & 1))
+			{
+				null_mark &= ~(1u << i);
+				std::memcpy(tmp_cache + header.col_offset[i], payload, header.col_length[i]);
+			}
+			payload += header.col_length[i];
+		}
+	}
+
+	((int*)tmp_cache)[1] = null_mark;
+	if(rid != nullptr) *rid = ((int*)tmp_cache)[0];
+	cache_row(tmp_cache, false);
+}
+
 void table_manager::cache_record(record_manager *rm)
 {
 	rm->seek(0);
-	rm->read(tmp_cache, tmp_record_size);
-	cache_record_from_tmp_cache();
+	auto block = rm->ptr();
+	int size = cached_size;
+	if(!size && block.second >= format.get_prefix_size())
+		size = format.get_size(block.first);
+	if(size && block.second >= size)
+	{
+		// read in place, the page is pinned by the row
+		cache_row(block.first, true, rm->position().first);
+	} else {
+		// the columns span overflow pages, which are followed only as
+		// far as the last column needed, or only the VARCHAR columns
+		// needed are read
+		if(cached_size) rm->read(tmp_row, cached_size);
+		else if(cached_cols != ~0u) read_columns(rm, tmp_row, cached_cols);
+		else read_stored(rm, tmp_row);
+		cache_row(tmp_row, true);
+	}
 }
 
-void table_manager::cache_record_from_tmp_cache()
+void table_manager::set_cached_columns(uint32_t cols)
 {
-	expression::cache_clear(header.table_name);
-	int null_mark = ((int*)tmp_cache)[1];
+	cached_size = format.get_read_size(cols);
+	cached_cols = cols;
+}
+
+void table_manager::cache_row(const char *record, bool stored, int pid)
+{
+	row.reset(record, stored, pid ? pg.get() : nullptr, pid);
+}
+
+const char* table_manager::get_cached_column(int cid)
+{
+	assert(cid >= 0 && cid < header.col_num);
+	const char *col = row.get_column(cid);
+	if(col && row.is_stored() && !format.is_fixed(cid))
+	{
+		// in its slot, as keys of the indices
+		char *buf = tmp_cache + header.col_offset[cid];
+		std::strncpy(buf, col, header.col_length[cid]);
+		return buf;
+	}
+
+	return col;
+}
+
+int table_manager::read_stored(record_manager *rm, char *buf)
+{
+	int prefix = format.get_prefix_size();
+	rm->seek(0);
+	rm->read(buf, prefix);
+	int size = format.get_size(buf);
+	rm->read(buf + prefix, size - prefix);
+	return size;
+}
+
+void table_manager::read_columns(record_manager *rm, char *buf, uint32_t cols)
+{
+	int prefix = format.get_prefix_size();
+	rm->seek(0);
+	rm->read(buf, prefix);
+
+	// in the order they are stored, so that seeks only go forward
+	std::pair<int, int> ranges[MAX_COL_NUM];
+	int num = 0;
 	for(int i = 0; i < header.col_num; ++i)
 	{
-		if(i == header.main_index && header.is_main_index_additional)
-			continue;
+		if(((cols >> i) & 1) && format.get_offset(i) < 0)
+		{
+			format.get_var_range(buf, i, ranges[num].first, ranges[num].second);
+			++num;
+		}
+	}
+
+	std::sort(ranges, ranges + num);
+	for(int i = 0; i != num; ++i)
+	{
+		int begin = ranges[i].first, end = ranges[i].second;
+		if(begin != end)
+			rm->seek(begin).read(buf + begin, end - begin);
+	}
+}
+
+int table_manager::read_record(record_manager *rm, char *buf)
+{
+	int size = read_stored(rm, tmp_stored);
+	format.unpack(tmp_stored, buf);
+	return size;
+}
+
+index_manager *table_manager::open_index(int cid)
+{
+	return new index_manager(pg.get(),
+		header.col_length[cid],
+		header.index_root[cid],
+		get_index_comparer(header.col_type[cid]),
+		get_index_payload_size(cid),
+		(header.flag_hash_index & (1u << cid))
+			? get_index_hasher(header.col_type[cid]) : nullptr
+	);
+}
+
+bitmap_index *table_manager::open_bitmap_index(int cid)
+{
+	return new bitmap_index(pg.get(),
+		header.bitmap_root[cid],
+		header.col_length[cid],
+		get_index_comparer(header.col_type[cid])
+	);
+}
 
-		char *buf = nullptr;
-		if(!((null_mark >> i) & 1))
-			buf = tmp_cache + header.col_offset[i];
+trigram_index *table_manager::open_trigram_index(int cid)
+{
+	return new trigram_index(pg.get(),
+		header.trigram_root[cid],
+		header.col_length[cid]
+	);
+}
 
-		expression::cache_column(
-			header.table_name,
-			header.col_name[i],
-			typecast::column_to_expr(buf, header.col_type[i])
-		);
+int table_manager::get_index_payload_size(int cid)
+{
+	uint32_t include = header.index_include[cid];
+	if(!include) return 0;
+	int size = 4;  // 4 bytes for not null
+	for(int i = 0; i < header.col_num; ++i)
+		if(include & (1u << i))
+			size += header.col_length[i];
+	return size;
+}
+
+const char *table_manager::fill_index_payload(int cid, const char *buf)
+{
+	uint32_t include = header.index_include[cid];
+	if(!include) return nullptr;
+	int null_mark = ((const int*)buf)[1];
+	*(int*)tmp_payload = null_mark & include;
+	char *dest = tmp_payload + 4;
+	for(int i = 0; i < header.col_num; ++i)
+	{
+		if(!(include & (1u << i)))
+			continue;
+		if((null_mark >> i) & 1)
+			std::memset(dest, 0, header.col_length[i]);
+		else std::memcpy(dest, buf + header.col_offset[i], header.col_length[i]);
+		dest += header.col_length[i];
 	}
+
+	return tmp_payload;
 }
 
-const char* table_manager::get_cached_column(int cid)
+index_manager *table_manager::open_composite_index(int idx)
 {
-	assert(cid >= 0 && cid < header.col_num);
-	int null_mark = ((int*)tmp_cache)[1];
-	if(!((null_mark >> cid) & 1))
-		return tmp_cache + header.col_offset[cid];
-	else return nullptr;
+	int size = get_composite_key_size(idx);
+	return new index_manager(pg.get(),
+		size,
+		header.composite_root[idx],
+		[size](const char *a, const char *b) -> int {
+			return std::memcmp(a, b, size);
+		}
+	);
+}
+
+int table_manager::get_composite_key_size(int idx)
+{
+	int size = 0;
+	for(int i = 0; i != header.composite_col_num[idx]; ++i)
+		size += sortable_key_length(header.col_length[header.composite_cols[idx][i]]);
+	return size;
+}
+
+void table_manager::fill_composite_key(int idx, const char *buf, char *dest)
+{
+	int null_mark = ((const int*)buf)[1];
+	for(int i = 0; i != header.composite_col_num[idx]; ++i)
+	{
+		int cid = header.composite_cols[idx][i];
+		const char *data = ((null_mark >> cid) & 1) ? nullptr : buf + header.col_offset[cid];
+		encode_sortable_key(header.col_type[cid], header.col_length[cid], data, dest);
+		dest += sortable_key_length(header.col_length[cid]);
+	}
 }
 
 void table_manager::load_indices()
@@ -78,16 +285,155 @@ void table_manager::load_indices()
 	for(int i = 0; i < header.col_num; ++i)
 	{
 		if(i != header.main_index && ((1u << i) & header.flag_indexed))
+			indices[i] = open_index(i);
+	}
+
+	std::memset(composite_indices, 0, sizeof(composite_indices));
+	for(int i = 0; i != header.composite_index_num; ++i)
+	{
+		composite_indices[i] = open_composite_index(i);
+		header.composite_lead_ndv[i] = -1;
+	}
+
+	std::memset(bitmap_indices, 0, sizeof(bitmap_indices));
+	std::memset(trigram_indices, 0, sizeof(trigram_indices));
+	for(int i = 0; i < header.col_num; ++i)
+	{
+		// no root if the table was not closed, see mark_bitmap_indices_stale
+		if((1u << i) & header.flag_bitmap_index)
 		{
-			indices[i] = new index_manager(pg.get(),
-				header.col_length[i],
-				header.index_root[i],
-				get_index_comparer(header.col_type[i])
-			);
+			bool stale = !header.bitmap_root[i];
+			bitmap_indices[i] = open_bitmap_index(i);
+			if(stale) index_existing_records_bitmap(i);
+		}
+
+		if((1u << i) & header.flag_trigram_index)
+		{
+			bool stale = !header.trigram_root[i];
+			trigram_indices[i] = open_trigram_index(i);
+			if(stale) index_existing_records_trigram(i);
+		}
+	}
+
+	open_bloom_filters();
+	rebuild_bloom_filters();
+}
+
+void table_manager::load_dictionaries()
+{
+	std::memset(dicts, 0, sizeof(dicts));
+	for(int i = 0; i < header.col_num; ++i)
+	{
+		if(!((header.flag_dictionary >> i) & 1))
+			continue;
+		dicts[i] = new dictionary(pg.get(), header.dict_root[i]);
+		header.dict_root[i] = dicts[i]->get_root_page_id();
+		format.set_dictionary(i, dicts[i]);
+	}
+}
+
+void table_manager::encode_columns(const char *record, int *codes)
+{
+	int null_mark = ((const int*)record)[1];
+	for(int i = 0; i < header.col_num; ++i)
+	{
+		if(!dicts[i] || ((null_mark >> i) & 1))
+			continue;
+		const char *col = record + header.col_offset[i];
+		codes[i] = dicts[i]->encode(std::string(col, strnlen(col, header.col_length[i] - 1)));
+	}
+}
+
+void table_manager::free_dictionaries()
+{
+	for(int i = 0; i < header.col_num; ++i)
+	{
+		if(!dicts[i]) continue;
+		header.dict_root[i] = dicts[i]->get_root_page_id();
+		delete dicts[i];
+		dicts[i] = nullptr;
+	}
+}
+
+int table_manager::read_code(record_manager *rm, int cid)
+{
+	int code;
+	rm->seek(format.get_offset(cid));
+	rm->read(&code, 4);
+	return code;
+}
+
+void table_manager::open_bloom_filters()
+{
+	for(int i = 0; i < header.col_num; ++i)
+	{
+		if(indices[i] && !indices[i]->get_bloom_filter())
+		{
+			indices[i]->open_bloom_filter(header.bloom_root[i],
+				get_index_hasher(header.col_type[i]));
+			header.bloom_root[i] = indices[i]->get_bloom_filter()->get_root_page_id();
+		}
+	}
+
+	for(int i = 0; i != header.composite_index_num; ++i)
+	{
+		if(composite_indices[i] && !composite_indices[i]->get_bloom_filter())
+		{
+			composite_indices[i]->open_bloom_filter(header.composite_bloom_root[i], bytes_hasher);
+			header.composite_bloom_root[i] = composite_indices[i]->get_bloom_filter()->get_root_page_id();
+		}
+	}
+}
+
+void table_manager::rebuild_bloom_filters()
+{
+	// filters just created or too full to be useful
+	std::vector<int> stale, stale_composite;
+	for(int i = 0; i < header.col_num; ++i)
+		if(indices[i] && indices[i]->get_bloom_filter()->is_stale())
+			stale.push_back(i);
+	for(int i = 0; i != header.composite_index_num; ++i)
+		if(composite_indices[i]->get_bloom_filter()->is_stale())
+			stale_composite.push_back(i);
+	if(stale.empty() && stale_composite.empty())
+		return;
+
+	int records = count_records();
+	for(int cid : stale)
+		indices[cid]->get_bloom_filter()->reset(records);
+	for(int idx : stale_composite)
+		composite_indices[idx]->get_bloom_filter()->reset(records);
+
+	auto it = get_record_iterator_lower_bound(0);
+	for(; !it.is_end(); it.next())
+	{
+		record_manager rm(pg.get());
+		rm.open(it.get(), false);
+		read_record(&rm, tmp_index);
+		int null_mark = ((int*)tmp_index)[1];
+		for(int cid : stale)
+		{
+			if(!((null_mark >> cid) & 1))
+				indices[cid]->get_bloom_filter()->add(tmp_index + header.col_offset[cid]);
+		}
+
+		for(int idx : stale_composite)
+		{
+			fill_composite_key(idx, tmp_index, tmp_key);
+			composite_indices[idx]->get_bloom_filter()->add(tmp_key);
 		}
 	}
 }
 
+int table_manager::count_records()
+{
+	int count = 0;
+	auto it = get_record_iterator_lower_bound(0);
+	for(; !it.is_end(); it.next())
+		++count;
+	return count;
+}
+
 void table_manager::free_indices()
 {
 	for(int i = 0; i < header.col_num; ++i)
@@ -96,10 +442,37 @@ void table_manager::free_indices()
 		{
 			assert(indices[i]);
 			header.index_root[i] = indices[i]->get_root_pid();
+			header.bloom_root[i] = indices[i]->get_bloom_filter()->get_root_page_id();
 			delete indices[i];
 			indices[i] = nullptr;
 		}
 	}
+
+	for(int i = 0; i != header.composite_index_num; ++i)
+	{
+		header.composite_root[i] = composite_indices[i]->get_root_pid();
+		header.composite_bloom_root[i] = composite_indices[i]->get_bloom_filter()->get_root_page_id();
+		delete composite_indices[i];
+		composite_indices[i] = nullptr;
+	}
+
+	for(int i = 0; i < header.col_num; ++i)
+	{
+		if(!bitmap_indices[i]) continue;
+		bitmap_indices[i]->flush();
+		header.bitmap_root[i] = bitmap_indices[i]->get_root_page_id();
+		delete bitmap_indices[i];
+		bitmap_indices[i] = nullptr;
+	}
+
+	for(int i = 0; i < header.col_num; ++i)
+	{
+		if(!trigram_indices[i]) continue;
+		trigram_indices[i]->flush();
+		header.trigram_root[i] = trigram_indices[i]->get_root_page_id();
+		delete trigram_indices[i];
+		trigram_indices[i] = nullptr;
+	}
 }
 
 void table_manager::free_check_constraints()
@@ -109,15 +482,19 @@ void table_manager::free_check_constraints()
 		expression::free_exprnode(check_conds[i]);
 		check_conds[i] = nullptr;
 	}
+
+	check_exprs.clear();
 }
 
 void table_manager::load_check_constraints()
 {
 	std::memset(check_conds, 0, sizeof(check_conds));
+	check_exprs.clear();
 	for(int i = 0; i != header.check_constaint_num; ++i)
 	{
 		std::istringstream is(header.check_constaints[i]);
 		check_conds[i] = expression::load_exprnode(is);
+		check_exprs.emplace_back(check_conds[i], &row, true);
 	}
 }
 
@@ -129,9 +506,17 @@ std::shared_ptr<table_manager> table_manager::mirror(const char *alias_name)
 	tb->is_mirror = true;
 	tb->pg = pg;
 	tb->btr = btr;
+	tb->zones = zones;
+	tb->columns = columns;
 	tb->header = header;
 	tb->allocate_temp_record();
 	std::memcpy(tb->indices, indices, sizeof(indices));
+	std::memcpy(tb->composite_indices, composite_indices, sizeof(composite_indices));
+	std::memcpy(tb->bitmap_indices, bitmap_indices, sizeof(bitmap_indices));
+	std::memcpy(tb->trigram_indices, trigram_indices, sizeof(trigram_indices));
+	std::memcpy(tb->dicts, dicts, sizeof(dicts));
+	for(int i = 0; i < header.col_num; ++i)
+		tb->format.set_dictionary(i, dicts[i]);
 	std::memcpy(tb->check_conds, check_conds, sizeof(check_conds));
 	std::strcpy(tb->header.table_name, alias_name);
 	return tb;
@@ -147,16 +532,42 @@ bool table_manager::open(const char *table_name)
 	std::ifstream ifs(thead, std::ios::binary);
 	ifs.read((char*)&header, sizeof(header));
 	pg = std::make_shared<pager>(tdata.c_str());
+	if(!pg->is_open())
+	{
+		pg = nullptr;
+		return false;
+	}
+
 	btr = std::make_shared<int_btree>(
 			pg.get(), header.index_root[header.main_index]);
 	allocate_temp_record();
+	open_zone_map();
+	open_column_cache();
+	load_dictionaries();
 	load_indices();
 	load_check_constraints();
+	mark_bitmap_indices_stale();
 
 	is_mirror = false;
 	return is_open = true;
 }
 
+void table_manager::mark_bitmap_indices_stale()
+{
+	/* bitmap and trigram indices are written only at close, so the header
+	 * on disk has no roots for them until then, and they are rebuilt from
+	 * the records if the table is not closed cleanly */
+	if(!header.flag_bitmap_index && !header.flag_trigram_index)
+		return;
+	table_header_t stale = header;
+	for(int i = 0; i < header.col_num; ++i)
+		stale.bitmap_root[i] = stale.trigram_root[i] = 0;
+
+	std::string thead = "data/" + tname + ".thead";
+	std::ofstream ofs(thead, std::ios::binary);
+	ofs.write((char*)&stale, sizeof(stale));
+}
+
 bool table_manager::create(const char *table_name, const table_header_t *header)
 {
 	if(is_open) return false;
@@ -169,6 +580,9 @@ bool table_manager::create(const char *table_name, const table_header_t *header)
 	this->header = *header;
 	this->header.index_root[header->main_index] = btr->get_root_page_id();
 	allocate_temp_record();
+	open_zone_map();
+	open_column_cache();
+	load_dictionaries();
 	load_indices();
 	load_check_constraints();
 
@@ -197,6 +611,7 @@ void table_manager::close()
 
 		header.index_root[header.main_index] = btr->get_root_page_id();
 		free_indices();
+		free_dictionaries();
 		free_check_constraints();
 
 		std::ofstream ofs(thead, std::ios::binary);
@@ -204,14 +619,25 @@ void table_manager::close()
 		pg->close();
 	}
 
+	row.release();
 	btr = nullptr;
+	zones = nullptr;
+	columns = nullptr;
 	pg = nullptr;
 	delete []tmp_record;
 	delete []tmp_cache;
 	delete []tmp_index;
+	delete []tmp_payload;
+	delete []tmp_key;
+	delete []tmp_stored;
+	delete []tmp_row;
 	tmp_cache = nullptr;
 	tmp_record = nullptr;
 	tmp_index = nullptr;
+	tmp_payload = nullptr;
+	tmp_key = nullptr;
+	tmp_stored = nullptr;
+	tmp_row = nullptr;
 	is_open = false;
 	is_mirror = false;
 }
@@ -234,11 +660,115 @@ void table_manager::allocate_temp_record()
 	for(int i = 0; i < header.col_num; ++i)
 		tot_len += header.col_length[i];
 	tmp_record = new char[tmp_record_size = tot_len];
+	format.init(&header);
+	cached_size = 0;
+	cached_cols = ~0u;
 	tmp_cache = new char[tot_len];
+	tmp_stored = new char[format.get_max_size()];
+	tmp_row = new char[format.get_max_size()];
 	tmp_index = new char[tot_len];
+	tmp_payload = new char[tot_len];
+	tmp_key = new char[tot_len + MAX_COL_NUM];
 	tmp_null_mark = reinterpret_cast<int*>(tmp_record + 4);
 }
 
+void table_manager::open_zone_map()
+{
+	std::vector<int> types, offsets;
+	for(int i = 0; i < header.col_num; ++i)
+	{
+		types.push_back(header.col_type[i]);
+		offsets.push_back(format.get_offset(i));
+	}
+
+	zones = std::make_shared<zone_map>(types, offsets);
+}
+
+bool table_manager::leaf_may_match(int pid, const std::vector<zone_map::cond_t> &conds)
+{
+	uint32_t version = btr->get_page_version(pid);
+	const zone_map::zone_t *zone = zones->find(pid, version);
+	if(!zone)
+	{
+		zone_map::zone_t &new_zone = zones->reset(pid, version);
+		int_btree::leaf_page page { pg->read(pid), pg.get() };
+		for(int pos = 0, size = page.size(); pos != size; ++pos)
+		{
+			record_manager rm(pg.get());
+			rm.open(pid, pos, false);
+			// the columns with zones are before the VARCHAR bytes
+			rm.read(tmp_stored, format.get_prefix_size());
+			zones->add(new_zone, tmp_stored);
+		}
+
+		zone = &new_zone;
+	}
+
+	return zones->may_match(*zone, conds);
+}
+
+void table_manager::open_column_cache()
+{
+	std::vector<int> types;
+	for(int i = 0; i < header.col_num; ++i)
+		types.push_back(header.col_type[i]);
+	columns = std::make_shared<column_cache>(types);
+}
+
+bool table_manager::select_leaf(int pid, const std::vector<zone_map::cond_t> &conds,
+		column_cache::selection_t &sel)
+{
+	if(!columns->is_hot(pid))
+		return false;
+
+	uint32_t version = btr->get_page_version(pid);
+	uint32_t missing = 0;
+	for(const zone_map::cond_t &cond : conds)
+		missing |= 1u << cond.cid;
+	missing &= ~columns->get_built(pid, version);
+
+	if(missing)
+	{
+		// the missing columns are read from the records in one pass
+		int_btree::leaf_page page { pg->read(pid), pg.get() };
+		int size = page.size();
+		int read_size = format.get_read_size(missing);
+		std::vector<zone_map::value_t> values[MAX_COL_NUM];
+		std::vector<uint64_t> nulls((size + 63) / 64);
+		std::vector<uint64_t> col_nulls[MAX_COL_NUM];
+		for(int i = 0; i < header.col_num; ++i)
+		{
+			if(!((missing >> i) & 1)) continue;
+			values[i].resize(size);
+			col_nulls[i] = nulls;
+		}
+
+		for(int pos = 0; pos != size; ++pos)
+		{
+			record_manager rm(pg.get());
+			rm.open(pid, pos, false);
+			rm.read(tmp_stored, read_size);
+			int null_mark = ((int*)tmp_stored)[1];
+			for(int i = 0; i < header.col_num; ++i)
+			{
+				if(!((missing >> i) & 1)) continue;
+				if((null_mark >> i) & 1)
+					col_nulls[i][pos >> 6] |= 1ull << (pos & 63);
+				else std::memcpy(&values[i][pos], tmp_stored + format.get_offset(i), 4);
+			}
+		}
+
+		for(int i = 0; i < header.col_num; ++i)
+		{
+			if((missing >> i) & 1)
+				columns->build(pid, version, i, values[i], col_nulls[i]);
+		}
+	}
+
+	columns->select(pid, conds, sel);
+	return true;
+}
+
 bool table_manager::set_temp_record(int col, const void *data)
 {
 	if(data == nullptr)
@@ -247,6 +777,10 @@ bool table_manager::set_temp_record(int col, const void *data)
 		return true;
 	}
 
+	if(header.col_type[col] == COL_TYPE_VARCHAR
+			&& std::strlen((const char*)data) >= (size_t)header.col_length[col])
+		return false;
+
 	*tmp_null_mark &= ~(1u << col);
 	switch(header.col_type[col])
 	{
@@ -285,67 +819,223 @@ void table_manager::init_temp_record()
 }
 
 int table_manager::insert_record()
+{
+	std::vector<std::string> records(1, get_temp_record());
+	insert_records(records);
+	return *(const int*)records[0].data();
+}
+
+table_manager::insert_batch_t::key_map table_manager::make_key_map(int cid)
+{
+	auto comparer = get_index_comparer(header.col_type[cid]);
+	return insert_batch_t::key_map([comparer](const std::string &a, const std::string &b) {
+		return comparer(a.data(), b.data()) < 0;
+	} );
+}
+
+int table_manager::insert_records(std::vector<std::string> &records)
 {
 	assert(header.col_offset[header.main_index] == 0);
-	int *rid = (int*)tmp_record;
-	if(header.is_main_index_additional)
-		*rid = header.auto_inc;
+	assert(header.is_main_index_additional);
 
-	if(header.check_constaint_num != 0)
+	int main_index_col = 1u << header.main_index;
+	int first_primary = -1;
+	if(!(header.flag_primary & main_index_col) && !header.composite_flag_primary)
 	{
-		std::memcpy(tmp_cache, tmp_record, tmp_record_size);
-		cache_record_from_tmp_cache();
+		first_primary = 0;
+		while(!(header.flag_primary & (1u << first_primary)))
+			++first_primary;
 	}
 
-	if(!check_constraints(tmp_record))
-		return false;
+	insert_batch_t batch;
+	for(int i = 0; i != header.col_num; ++i)
+	{
+		if(i == first_primary || ((header.flag_unique & ~main_index_col) & (1u << i)))
+			batch.unique.emplace(i, make_key_map(i));
+	}
+
+	for(int i = 0; i != header.foreign_key_num; ++i)
+		batch.foreign.push_back(make_key_map(header.foreign_key[i]));
+
+	// check the records in order, as if they were inserted one by one
+	std::vector<char*> accepted;
+	for(std::string &record : records)
+	{
+		char *buf = &record[0];
+		*(int*)buf = header.auto_inc;
+		if(header.check_constaint_num != 0)
+			cache_row(buf, false);
+
+		if(!check_constraints(buf, &batch))
+		{
+			*(int*)buf = 0;
+			continue;
+		}
+
+		int null_mark = ((int*)buf)[1];
+		for(auto &keys : batch.unique)
+		{
+			int cid = keys.first;
+			if(!((null_mark >> cid) & 1))
+				keys.second.emplace(std::string(buf + header.col_offset[cid], header.col_length[cid]), *(int*)buf);
+		}
+
+		for(int i = 0; i != header.composite_index_num; ++i)
+		{
+			if(header.composite_flag_primary & (1u << i))
+			{
+				fill_composite_key(i, buf, tmp_key);
+				batch.composite_primary.emplace(std::string(tmp_key, get_composite_key_size(i)), *(int*)buf);
+			}
+		}
 
-	btr->insert(*rid, tmp_record, tmp_record_size);
+		++header.records_num;
+		++header.auto_inc;
+		accepted.push_back(buf);
+	}
+
+	// the records may be freed by the caller
+	row.release();
+
+	// rids are increasing, so the records are appended to the right-most leaf
+	int codes[MAX_COL_NUM];
+	for(char *buf : accepted)
+	{
+		encode_columns(buf, codes);
+		int size = format.pack(buf, codes, tmp_stored);
+		btr->insert(*(int*)buf, tmp_stored, size);
+		int pid = btr->get_last_insert_page();
+		zones->widen(pid, btr->get_page_version(pid), tmp_stored);
+		columns->invalidate(pid);
+	}
+
+	for(char *buf : accepted)
+	{
+		int rid = *(int*)buf;
+		int null_mark = ((int*)buf)[1];
+		for(int i = 0; i < header.col_num; ++i)
+		{
+			if(i != header.main_index && ((1u << i) & header.flag_indexed))
+			{
+				assert(indices[i]);
+				const char *payload = fill_index_payload(i, buf);
+				if((null_mark >> i) & 1)
+					indices[i]->insert_later(nullptr, rid, payload);
+				else indices[i]->insert_later(buf + header.col_offset[i], rid, payload);
+			}
+		}
+
+		for(int i = 0; i != header.composite_index_num; ++i)
+		{
+			fill_composite_key(i, buf, tmp_key);
+			composite_indices[i]->insert_later(tmp_key, rid);
+		}
+
+		for(int i = 0; i < header.col_num; ++i)
+		{
+			if(!bitmap_indices[i]) continue;
+			if((null_mark >> i) & 1)
+				bitmap_indices[i]->insert(nullptr, rid);
+			else bitmap_indices[i]->insert(buf + header.col_offset[i], rid);
+		}
+
+		for(int i = 0; i < header.col_num; ++i)
+		{
+			if(trigram_indices[i] && !((null_mark >> i) & 1))
+				trigram_indices[i]->insert(buf + header.col_offset[i], rid);
+		}
+	}
 
+	// each index is filled in key order
 	for(int i = 0; i < header.col_num; ++i)
 	{
 		if(i != header.main_index && ((1u << i) & header.flag_indexed))
-		{
-			assert(indices[i]);
-			if(*tmp_null_mark & (1u << i))
-				indices[i]->insert(nullptr, *rid);
-			else indices[i]->insert(tmp_record + header.col_offset[i], *rid);
-		}
+			indices[i]->insert_pending();
 	}
 
-	if(header.is_main_index_additional)
+	for(int i = 0; i != header.composite_index_num; ++i)
 	{
-		++header.records_num;
-		++header.auto_inc;
+		composite_indices[i]->insert_pending();
+		header.composite_lead_ndv[i] = -1;
 	}
-	return *rid;
+
+	return accepted.size();
 }
 
 bool table_manager::remove_record(int rid)
+{
+	return remove_records(std::vector<int>(1, rid)) != 0;
+}
+
+int table_manager::remove_records(std::vector<int> rids)
 {
 	assert(!is_mirror);
-	record_manager rm = get_record_ptr(rid);
-	if(rm.valid())
+	if(rids.empty()) return 0;
+	std::sort(rids.begin(), rids.end());
+	rids.erase(std::unique(rids.begin(), rids.end()), rids.end());
+
+	// walk the records in rid order and queue the index entries,
+	// then erase from each tree in a single pass
+	std::vector<int> removed;
+	auto it = get_record_iterator_lower_bound(rids[0]);
+	for(int rid : rids)
 	{
-		int null_mark;
-		rm.seek(4);
-		rm.read(&null_mark, 4);
+		if(!seek_record_iterator(it, rid))
+			continue;
+		record_manager rm(pg.get());
+		rm.open(it.get(), false);
+		read_record(&rm, tmp_index);
+		int null_mark = ((int*)tmp_index)[1];
 		for(int i = 0; i < header.col_num; ++i)
 		{
 			if(i != header.main_index && ((1u << i) & header.flag_indexed))
 			{
 				assert(indices[i]);
 				if(!((null_mark >> i) & 1))
-				{
-					rm.seek(header.col_offset[i]);
-					rm.read(tmp_index, header.col_length[i]);
-					indices[i]->erase(tmp_index, rid);
-				} else indices[i]->erase(nullptr, rid);
+					indices[i]->erase_later(tmp_index + header.col_offset[i], rid);
+				else indices[i]->erase_later(nullptr, rid);
 			}
 		}
-		btr->erase(rid);
-		return true;
-	} else return false;
+
+		for(int i = 0; i != header.composite_index_num; ++i)
+		{
+			fill_composite_key(i, tmp_index, tmp_key);
+			composite_indices[i]->erase_later(tmp_key, rid);
+		}
+
+		for(int i = 0; i < header.col_num; ++i)
+		{
+			if(!bitmap_indices[i]) continue;
+			bool ret = bitmap_indices[i]->erase(((null_mark >> i) & 1)
+				? nullptr : tmp_index + header.col_offset[i], rid);
+			assert(ret);
+			UNUSED(ret);
+		}
+
+		for(int i = 0; i < header.col_num; ++i)
+		{
+			if(trigram_indices[i] && !((null_mark >> i) & 1))
+				trigram_indices[i]->erase(tmp_index + header.col_offset[i], rid);
+		}
+
+		columns->invalidate(it.get().first);
+		removed.push_back(rid);
+	}
+
+	for(int i = 0; i < header.col_num; ++i)
+	{
+		if(i != header.main_index && ((1u << i) & header.flag_indexed))
+			indices[i]->erase_pending();
+	}
+
+	for(int i = 0; i != header.composite_index_num; ++i)
+	{
+		composite_indices[i]->erase_pending();
+		header.composite_lead_ndv[i] = -1;
+	}
+
+	btr->erase_batch(removed);
+	return removed.size();
 }
 
 btree_iterator<int_btree::leaf_page> table_manager::get_record_iterator_lower_bound(int rid)
@@ -354,6 +1044,32 @@ btree_iterator<int_btree::leaf_page> table_manager::get_record_iterator_lower_bo
 	return { pg.get(), ret.first, ret.second };
 }
 
+bool table_manager::seek_record_iterator(btree_iterator<int_btree::leaf_page> &it, int rid)
+{
+	for(int i = 0, pid = it.get().first; i != 2 && pid; ++i)
+	{
+		int_btree::leaf_page page { pg->read(pid), pg.get() };
+		if(page.size() == 0 || page.get_key(0) > rid)
+			break;
+		if(page.get_key(page.size() - 1) >= rid)
+		{
+			int pos = ::lower_bound(0, page.size(), [&](int id) {
+				return page.get_key(id) < rid;
+			} );
+
+			it = { pg.get(), pid, pos };
+			return page.get_key(pos) == rid;
+		}
+
+		pid = page.next_page();
+	}
+
+	it = get_record_iterator_lower_bound(rid);
+	if(it.is_end()) return false;
+	int_btree::leaf_page page { pg->read(it.get().first), pg.get() };
+	return page.get_key(it.get().second) == rid;
+}
+
 record_manager table_manager::get_record_ptr_lower_bound(int rid, bool dirty)
 {
 	auto ret = btr->lower_bound(rid);
@@ -384,6 +1100,27 @@ void table_manager::dump_header(FILE *f, std::vector<std::string>& heads)
 	}
 }
 
+void table_manager::dump_table_info()
+{
+	std::printf("======== Table Info Begin ========\n");
+	header.dump();
+
+	int leaves = 0, free_size = 0, fragmented = 0;
+	auto it = get_record_iterator_lower_bound(0);
+	for(; !it.is_end(); it.next_page())
+	{
+		int_btree::leaf_page page { pg->read(it.get().first), pg.get() };
+		++leaves;
+		free_size += page.free_size();
+		fragmented += page.fragmented_size();
+	}
+
+	std::printf("Data pages  = %d, free = %d bytes, fragmented = %d bytes\n",
+		leaves, free_size, fragmented);
+	std::printf("Defragments = %d\n", pg->get_defragment_count());
+	std::printf("======== Table Info End   ========\n");
+}
+
 void table_manager::dump_record(FILE *f, int rid, std::vector<std::string>& row_)
 {
 	record_manager rec = get_record_ptr(rid);
@@ -392,8 +1129,7 @@ void table_manager::dump_record(FILE *f, int rid, std::vector<std::string>& row_
 
 void table_manager::dump_record(FILE *f, record_manager *rm, std::vector<std::string>& row_)
 {
-	rm->seek(0);
-	rm->read(tmp_cache, tmp_record_size);
+	read_record(rm, tmp_cache);
 	int null_mark = ((int*)tmp_cache)[1];
 	for(int i = 0; i < header.col_num - 1; ++i)
 	{
@@ -443,49 +1179,167 @@ void table_manager::dump_record(FILE *f, record_manager *rm, std::vector<std::st
 	}
 }
 
-bool table_manager::modify_record(int rid, int col, const void* data)
+int table_manager::modify_records(std::vector<int> rids, uint32_t cols,
+		const std::function<bool()> &fill)
 {
 	assert(!is_mirror);
-	record_manager rec = get_record_ptr(rid, true);
-	if(!rec.valid()) return false;
-	assert(col >= 0 && col < header.col_num);
+	if(rids.empty()) return 0;
+	std::sort(rids.begin(), rids.end());
+	rids.erase(std::unique(rids.begin(), rids.end()), rids.end());
 
-	// record must be cached by cache_record()
-	int is_old_record_null = ((int*)tmp_cache)[1] & (1u << col);
-	if(data == nullptr)
+	int modified = 0;
+	auto it = get_record_iterator_lower_bound(rids[0]);
+	for(int rid : rids)
 	{
-		((int*)tmp_cache)[1] |= 1u << col;
-	} else {
-		std::memcpy(tmp_record, tmp_cache + header.col_offset[col], header.col_length[col]);
-		std::memcpy(tmp_cache + header.col_offset[col], data, header.col_length[col]);
+		if(!seek_record_iterator(it, rid))
+			continue;
+		record_manager rm(pg.get());
+		rm.open(it.get(), false);
+		cache_record(&rm);
+		if(!fill()) break;
+
+		bool moved = false;
+		if(modify_record(&rm, cols, moved))
+			++modified;
+		// the leaves may be split or merged by moving the record
+		if(moved) it = get_record_iterator_lower_bound(rid);
 	}
 
-	expression::cache_replace(
-		header.table_name,
-		header.col_name[col], 
-		typecast::column_to_expr((char*)data, header.col_type[col])
-	);
+	for(int i = 0; i < header.col_num; ++i)
+	{
+		if(indices[i] && i != header.main_index)
+		{
+			indices[i]->erase_pending();
+			indices[i]->insert_pending();
+		}
+	}
+
+	for(int i = 0; i != header.composite_index_num; ++i)
+	{
+		composite_indices[i]->erase_pending();
+		composite_indices[i]->insert_pending();
+		header.composite_lead_ndv[i] = -1;
+	}
+
+	return modified;
+}
+
+bool table_manager::modify_record(record_manager *rm, uint32_t cols, bool &moved)
+{
+	// the old record is kept in tmp_index for updating indices
+	int old_size = read_record(rm, tmp_index);
+	int rid = *(int*)tmp_index;
+	int old_null_mark = ((int*)tmp_index)[1];
+	int null_mark = (old_null_mark & ~cols) | (*tmp_null_mark & cols);
+	std::memcpy(tmp_cache, tmp_index, tmp_record_size);
+	((int*)tmp_cache)[1] = null_mark;
+	for(int i = 0; i < header.col_num; ++i)
+	{
+		if(!((cols >> i) & 1) || ((null_mark >> i) & 1))
+			continue;
+		char *value = tmp_cache + header.col_offset[i];
+		int length = header.col_length[i];
+		if(header.col_type[i] == COL_TYPE_VARCHAR)
+		{
+			std::strncpy(value, tmp_record + header.col_offset[i], length);
+			value[length - 1] = 0;
+		} else {
+			std::memcpy(value, tmp_record + header.col_offset[i], length);
+		}
+	}
+
+	// an unchanged record is left alone, and so are its pages
+	if(std::memcmp(tmp_cache, tmp_index, tmp_record_size) == 0)
+		return true;
 
+	// the constraints see the new record
+	cache_row(tmp_cache, false);
 	if(!check_constraints(tmp_cache))
 		return false;
 
-	if(data != nullptr)
+	int codes[MAX_COL_NUM];
+	encode_columns(tmp_cache, codes);
+	int size = format.pack(tmp_cache, codes, tmp_stored);
+	// the column segments of the old and the new leaf are dropped
+	int pid = rm->position().first;
+	columns->invalidate(pid);
+	if(size == old_size)
 	{
-		rec.seek(header.col_offset[col]);
-		rec.write(data, header.col_length[col]);
+		rm->seek(0);
+		rm->write(tmp_stored, size);
 	} else {
-		rec.seek(4);
-		rec.write(tmp_cache + 4, 4);
+		// the record is moved, as its size changes
+		btr->erase(rid);
+		btr->insert(rid, tmp_stored, size);
+		pid = btr->get_last_insert_page();
+		moved = true;
+	}
+
+	zones->widen(pid, btr->get_page_version(pid), tmp_stored);
+	columns->invalidate(pid);
+
+	/* entries of indices which are not looked up by the constraints are
+	 * queued, and the others are updated at once */
+	uint32_t checked = header.flag_unique | header.flag_primary;
+	for(int i = 0; i < header.col_num; ++i)
+	{
+		if(!indices[i] || i == header.main_index)
+			continue;
+		if(!((cols >> i) & 1) && !(header.index_include[i] & cols))
+			continue;
+		const char *old_key = ((old_null_mark >> i) & 1) ? nullptr : tmp_index + header.col_offset[i];
+		const char *key = ((null_mark >> i) & 1) ? nullptr : tmp_cache + header.col_offset[i];
+		if((checked >> i) & 1)
+		{
+			indices[i]->erase(old_key, rid);
+			indices[i]->insert(key, rid, fill_index_payload(i, tmp_cache));
+		} else {
+			indices[i]->erase_later(old_key, rid);
+			indices[i]->insert_later(key, rid, fill_index_payload(i, tmp_cache));
+		}
+	}
+
+	for(int i = 0; i < header.col_num; ++i)
+	{
+		if(!((cols >> i) & 1))
+			continue;
+		const char *old_key = ((old_null_mark >> i) & 1) ? nullptr : tmp_index + header.col_offset[i];
+		const char *key = ((null_mark >> i) & 1) ? nullptr : tmp_cache + header.col_offset[i];
+		if(bitmap_indices[i])
+		{
+			bool ret = bitmap_indices[i]->erase(old_key, rid);
+			assert(ret);
+			UNUSED(ret);
+			bitmap_indices[i]->insert(key, rid);
+		}
+
+		if(trigram_indices[i])
+		{
+			if(old_key) trigram_indices[i]->erase(old_key, rid);
+			if(key) trigram_indices[i]->insert(key, rid);
+		}
 	}
 
-	if(indices[col] != nullptr)
+	for(int i = 0; i != header.composite_index_num; ++i)
 	{
-		// update index
-		if(is_old_record_null)
-			indices[col]->erase(nullptr, rid);
-		else indices[col]->erase(tmp_record, rid);
-		indices[col]->insert((const char*)data, rid);
+		uint32_t composite_cols = 0;
+		for(int j = 0; j != header.composite_col_num[i]; ++j)
+			composite_cols |= 1u << header.composite_cols[i][j];
+		if(!(composite_cols & cols))
+			continue;
+		fill_composite_key(i, tmp_index, tmp_key);
+		if(header.composite_flag_primary & (1u << i))
+		{
+			composite_indices[i]->erase(tmp_key, rid);
+			fill_composite_key(i, tmp_cache, tmp_key);
+			composite_indices[i]->insert(tmp_key, rid);
+		} else {
+			composite_indices[i]->erase_later(tmp_key, rid);
+			fill_composite_key(i, tmp_cache, tmp_key);
+			composite_indices[i]->insert_later(tmp_key, rid);
+		}
 	}
+
 	return true;
 }
 
@@ -495,6 +1349,25 @@ index_manager* table_manager::get_index(int cid)
 	return indices[cid];
 }
 
+bitmap_index* table_manager::get_bitmap_index(int cid)
+{
+	assert(cid >= 0 && cid < header.col_num);
+	return bitmap_indices[cid];
+}
+
+trigram_index* table_manager::get_trigram_index(int cid)
+{
+	assert(cid >= 0 && cid < header.col_num);
+	return trigram_indices[cid];
+}
+
+uint32_t table_manager::get_index_covered(int cid)
+{
+	assert(cid >= 0 && cid < header.col_num);
+	if(!indices[cid]) return 0;
+	return (1u << cid) | (1u << header.main_index) | header.index_include[cid];
+}
+
 bool table_manager::has_index(const char *col_name)
 {
 	int cid = lookup_column(col_name);
@@ -507,27 +1380,244 @@ bool table_manager::has_index(int cid)
 	return (header.flag_indexed >> cid) & 1u;
 }
 
-void table_manager::create_index(const char *col_name)
+void table_manager::create_index(const char *col_name, uint32_t include, bool use_hash)
 {
 	int cid = lookup_column(col_name);
 	if(cid < 0)
 	{
 		std::fprintf(stderr, "[Error] column `%s' not exists.\n", col_name);
-	} else if(has_index(cid)) {
+		return;
+	} else if(has_index(cid) || bitmap_indices[cid]) {
 		std::fprintf(stderr, "[Error] index for column `%s' already exists.\n", col_name);
-	} else {
-		header.flag_indexed |= 1u << cid;
-		indices[cid] = new index_manager(pg.get(),
-			header.col_length[cid],
-			header.index_root[cid],
-			get_index_comparer(header.col_type[cid])
-		);
+		return;
+	}
+
+	include &= ~(1u << cid);
+	include &= ~(1u << header.main_index);
+	header.index_include[cid] = include;
+
+	if(!index_entry_fits(header.col_length[cid], get_index_payload_size(cid)))
+	{
+		std::fprintf(stderr, "[Error] index entry of column `%s' too large.\n", col_name);
+		header.index_include[cid] = 0;
+		return;
+	}
+
+	header.flag_indexed |= 1u << cid;
+	if(use_hash) header.flag_hash_index |= 1u << cid;
+	header.index_root[cid] = 0;
+	header.bloom_root[cid] = 0;
+	indices[cid] = open_index(cid);
+	open_bloom_filters();
+	indices[cid]->get_bloom_filter()->reset(count_records());
+	index_existing_records(cid);
+}
+
+bool table_manager::create_bitmap_index(const char *col_name)
+{
+	int cid = lookup_column(col_name);
+	if(cid < 0)
+	{
+		std::fprintf(stderr, "[Error] column `%s' not exists.\n", col_name);
+		return false;
+	} else if(has_index(cid) || bitmap_indices[cid]) {
+		std::fprintf(stderr, "[Error] index for column `%s' already exists.\n", col_name);
+		return false;
+	}
+
+	header.flag_bitmap_index |= 1u << cid;
+	header.bitmap_root[cid] = 0;
+	bitmap_indices[cid] = open_bitmap_index(cid);
+	index_existing_records_bitmap(cid);
+	return true;
+}
+
+void table_manager::index_existing_records_bitmap(int cid)
+{
+	assert(bitmap_indices[cid]);
+	auto it = get_record_iterator_lower_bound(0);
+	for(; !it.is_end(); it.next())
+	{
+		record_manager rm(pg.get());
+		rm.open(it.get(), false);
+		read_record(&rm, tmp_index);
+		int null_mark = ((int*)tmp_index)[1];
+		bitmap_indices[cid]->insert(((null_mark >> cid) & 1)
+			? nullptr : tmp_index + header.col_offset[cid], *(int*)tmp_index);
+	}
+}
+
+bool table_manager::create_trigram_index(const char *col_name)
+{
+	int cid = lookup_column(col_name);
+	if(cid < 0)
+	{
+		std::fprintf(stderr, "[Error] column `%s' not exists.\n", col_name);
+		return false;
+	} else if(header.col_type[cid] != COL_TYPE_VARCHAR) {
+		std::fprintf(stderr, "[Error] trigram index is only for VARCHAR column.\n");
+		return false;
+	} else if(trigram_indices[cid]) {
+		std::fprintf(stderr, "[Error] trigram index for column `%s' already exists.\n", col_name);
+		return false;
+	}
+
+	header.flag_trigram_index |= 1u << cid;
+	header.trigram_root[cid] = 0;
+	trigram_indices[cid] = open_trigram_index(cid);
+	index_existing_records_trigram(cid);
+	return true;
+}
+
+void table_manager::index_existing_records_trigram(int cid)
+{
+	assert(trigram_indices[cid]);
+	auto it = get_record_iterator_lower_bound(0);
+	for(; !it.is_end(); it.next())
+	{
+		record_manager rm(pg.get());
+		rm.open(it.get(), false);
+		read_record(&rm, tmp_index);
+		int null_mark = ((int*)tmp_index)[1];
+		if(!((null_mark >> cid) & 1))
+			trigram_indices[cid]->insert(tmp_index + header.col_offset[cid], *(int*)tmp_index);
+	}
+}
+
+bool table_manager::create_composite_index(const std::vector<int> &cols)
+{
+	int col_num = cols.size();
+	if(col_num < 2 || col_num > MAX_COMPOSITE_INDEX_COL)
+	{
+		std::fprintf(stderr, "[Error] composite index must have 2 to %d columns.\n",
+				MAX_COMPOSITE_INDEX_COL);
+		return false;
+	}
+
+	if(header.composite_index_num == MAX_COMPOSITE_INDEX_NUM)
+	{
+		std::fprintf(stderr, "[Error] too many composite indices.\n");
+		return false;
+	}
+
+	for(int i = 0; i != col_num; ++i)
+	{
+		if(cols[i] < 0 || cols[i] >= header.col_num)
+		{
+			std::fprintf(stderr, "[Error] column not exists.\n");
+			return false;
+		}
+
+		for(int j = 0; j != i; ++j)
+		{
+			if(cols[i] == cols[j])
+			{
+				std::fprintf(stderr, "[Error] duplicated column `%s' in index.\n",
+						header.col_name[cols[i]]);
+				return false;
+			}
+		}
+	}
+
+	for(int i = 0; i != header.composite_index_num; ++i)
+	{
+		if(header.composite_col_num[i] == col_num && std::equal(
+				cols.begin(), cols.end(), header.composite_cols[i]))
+		{
+			std::fprintf(stderr, "[Error] index already exists.\n");
+			return false;
+		}
+	}
+
+	int idx = header.composite_index_num;
+	header.composite_col_num[idx] = col_num;
+	for(int i = 0; i != col_num; ++i)
+		header.composite_cols[idx][i] = cols[i];
+	if(!index_entry_fits(get_composite_key_size(idx), 0))
+	{
+		std::fprintf(stderr, "[Error] index entry too large.\n");
+		header.composite_col_num[idx] = 0;
+		return false;
+	}
+
+	header.composite_root[idx] = 0;
+	header.composite_bloom_root[idx] = 0;
+	composite_indices[idx] = open_composite_index(idx);
+	++header.composite_index_num;
+	open_bloom_filters();
+	composite_indices[idx]->get_bloom_filter()->reset(count_records());
+	index_existing_records_composite(idx);
+	header.composite_lead_ndv[idx] = -1;
+	return true;
+}
+
+int table_manager::get_composite_lead_ndv(int idx)
+{
+	// counted when planning, after the index has changed
+	if(header.composite_lead_ndv[idx] < 0)
+		analyze_composite_index(idx);
+	return header.composite_lead_ndv[idx];
+}
+
+void table_manager::analyze_composite_index(int idx)
+{
+	// count groups of the leading column by seeking past each of them
+	int key_size = get_composite_key_size(idx);
+	int lead_len = sortable_key_length(header.col_length[header.composite_cols[idx][0]]);
+	std::vector<char> key(key_size, 0);
+	int ndv = 0;
+	auto it = composite_indices[idx]->get_iterator_lower_bound(key.data());
+	while(!it.is_end() && ndv <= SKIP_SCAN_MAX_GROUPS)
+	{
+		++ndv;
+		const char *entry = composite_indices[idx]->get_entry(it.get());
+		std::memcpy(key.data(), index_manager::entry_key(entry), lead_len);
+		// a not-null mark is 0 or 1, so this is above any key of the group
+		std::memset(key.data() + lead_len, 0xff, key_size - lead_len);
+		it = composite_indices[idx]->get_iterator_lower_bound(key.data());
+	}
+
+	header.composite_lead_ndv[idx] = ndv;
+}
+
+bool table_manager::index_entry_fits(int key_size, int payload_size)
+{
+	// each index page must hold at least PAGE_BLOCK_MIN_NUM entries
+	int entry_size = sizeof(int) + 1 + key_size + payload_size;
+	return (PAGE_SIZE - index_btree::interior_page::header_size())
+		/ (entry_size + 4) >= PAGE_BLOCK_MIN_NUM;
+}
 
-		// TODO: add existed data.
+void table_manager::index_existing_records_composite(int idx)
+{
+	assert(composite_indices[idx]);
+	auto it = get_record_iterator_lower_bound(0);
+	for(; !it.is_end(); it.next())
+	{
+		record_manager rm(pg.get());
+		rm.open(it.get(), false);
+		read_record(&rm, tmp_index);
+		fill_composite_key(idx, tmp_index, tmp_key);
+		composite_indices[idx]->insert(tmp_key, *(int*)tmp_index);
+	}
+}
+
+void table_manager::index_existing_records(int cid)
+{
+	assert(indices[cid]);
+	auto it = get_record_iterator_lower_bound(0);
+	for(; !it.is_end(); it.next())
+	{
+		record_manager rm(pg.get());
+		rm.open(it.get(), false);
+		read_record(&rm, tmp_index);
+		int null_mark = ((int*)tmp_index)[1];
+		const char *key = ((null_mark >> cid) & 1) ? nullptr : tmp_index + header.col_offset[cid];
+		indices[cid]->insert(key, *(int*)tmp_index, fill_index_payload(cid, tmp_index));
 	}
 }
 
-bool table_manager::check_constraints(const char *buf)
+bool table_manager::check_constraints(const char *buf, insert_batch_t *batch)
 {
 	if(!check_notnull(buf))
 		return false;
@@ -536,7 +1626,7 @@ bool table_manager::check_constraints(const char *buf)
 	if(!(header.flag_primary & main_index_col))
 	{
 		// primary key is not __rowid__
-		if(!check_primary(buf))
+		if(!check_primary(buf, batch))
 			return false;
 	}
 
@@ -544,7 +1634,7 @@ bool table_manager::check_constraints(const char *buf)
 	for(int i = 0; i != header.col_num; ++i)
 	{
 		if(unique_to_check & (1u << i))
-			if(!check_unique(buf, i))
+			if(!check_unique(buf, i, batch))
 			{
 				std::fprintf(stderr, "[Error] Record not unique!\n");
 				return false;
@@ -553,7 +1643,7 @@ bool table_manager::check_constraints(const char *buf)
 
 	for(int i = 0; i != header.check_constaint_num; ++i)
 	{
-		if(!check_value_constraint(check_conds[i]))
+		if(!check_value_constraint(check_exprs[i]))
 		{
 			std::fprintf(stderr, "[Error] Value constraint broken!\n");
 			return false;
@@ -562,7 +1652,7 @@ bool table_manager::check_constraints(const char *buf)
 
 	for(int i = 0; i != header.foreign_key_num; ++i)
 	{
-		if(!check_foreign(buf, i))
+		if(!check_foreign(buf, i, batch))
 		{
 			std::fprintf(stderr, "[Error] Foreign key constraint broken!\n");
 			return false;
@@ -572,77 +1662,105 @@ bool table_manager::check_constraints(const char *buf)
 	return true;
 }
 
-bool table_manager::check_foreign(const char *buf, int key_id)
+bool table_manager::check_foreign(const char *buf, int key_id, insert_batch_t *batch)
 {
 	int cid = header.foreign_key[key_id];
-	return dbms::get_instance()->value_exists(
+	std::string key(buf + header.col_offset[cid], header.col_length[cid]);
+	// each key is looked up in the parent table once per batch
+	if(batch && batch->foreign[key_id].count(key))
+		return true;
+
+	bool found = dbms::get_instance()->value_exists(
 		header.foreign_key_ref_table[key_id],
 		header.foreign_key_ref_column[key_id],
-		buf + header.col_offset[cid]
+		key.data()
 	);
+
+	if(!found && batch && std::strcmp(header.foreign_key_ref_table[key_id], header.table_name) == 0)
+	{
+		// referencing a record accepted earlier in the batch
+		auto keys = batch->unique.find(lookup_column(header.foreign_key_ref_column[key_id]));
+		found = keys != batch->unique.end() && keys->second.count(key);
+	}
+
+	if(found && batch)
+		batch->foreign[key_id].emplace(key, 0);
+	return found;
 }
 
-bool table_manager::check_unique(const char *buf, int col)
+bool table_manager::check_unique(const char *buf, int col, insert_batch_t *batch)
 {
 	assert(indices[col]);
-	auto it = indices[col]->get_iterator_lower_bound(buf + header.col_offset[col]);
-	if(it.is_end())
-		return true;
-
-	int dest_rid;
-	record_manager r = open_record_from_index_lower_bound(it.get(), &dest_rid);
-	if(dest_rid == *(int*)buf)
+	auto it = indices[col]->get_equal_iterator(buf + header.col_offset[col]);
+	for(; !it.is_end(); it.next())
 	{
-		it.next();
-		if(it.is_end()) return true;
-		r = open_record_from_index_lower_bound(it.get(), &dest_rid);
+		if(index_manager::entry_rid(indices[col]->get_entry(it.get())) != *(int*)buf)
+			return false;
 	}
 
-	// compare values 
-	r.seek(header.col_offset[col]);
-	r.read(tmp_index, header.col_length[col]);
-	auto comparer = get_index_comparer(header.col_type[col]);
-	return comparer(tmp_index, buf + header.col_offset[col]) != 0;
+	return !batch || !batch->unique.at(col).count(
+		std::string(buf + header.col_offset[col], header.col_length[col]));
 }
 
-bool table_manager::check_primary(const char *buf)
+bool table_manager::check_primary(const char *buf, insert_batch_t *batch)
 {
+	if(header.composite_flag_primary)
+	{
+		// single probe in the composite index of primary key
+		int idx = 0;
+		while(!(header.composite_flag_primary & (1u << idx)))
+			++idx;
+		fill_composite_key(idx, buf, tmp_key);
+		auto it = composite_indices[idx]->get_equal_iterator(tmp_key);
+		for(; !it.is_end(); it.next())
+		{
+			int rid = index_manager::entry_rid(composite_indices[idx]->get_entry(it.get()));
+			if(rid != *(int*)buf)
+			{
+				std::fprintf(stderr, "[Error] Primary key confliction with __rowid__ = %d\n", rid);
+				return false;
+			}
+		}
+
+		if(batch)
+		{
+			auto pk = batch->composite_primary.find(std::string(tmp_key, get_composite_key_size(idx)));
+			if(pk != batch->composite_primary.end())
+			{
+				std::fprintf(stderr, "[Error] Primary key confliction with __rowid__ = %d\n", pk->second);
+				return false;
+			}
+		}
+
+		return true;
+	}
+
 	int first_primary = 0;
 	while(!(header.flag_primary & (1u << first_primary)))
 		++first_primary;
 
 	assert(indices[first_primary]);
-	auto it = indices[first_primary]->get_iterator_lower_bound(
+	auto it = indices[first_primary]->get_equal_iterator(
 			buf + header.col_offset[first_primary]);
-
 	for(; !it.is_end(); it.next())
 	{
-		int rid;
-		record_manager rm = open_record_from_index_lower_bound(it.get(), &rid);
-		if(rid == *(int*)buf)
-			continue;
-
-		int first_not_conflicted = -1;
-		for(int i = 0; i != header.col_num; ++i)
+		int rid = index_manager::entry_rid(indices[first_primary]->get_entry(it.get()));
+		if(rid != *(int*)buf)
 		{
-			if(!(header.flag_primary & (1u << i)))
-				continue;
-			rm.seek(header.col_offset[i]);
-			rm.read(tmp_index, header.col_length[i]);
-			auto comparer = get_index_comparer(header.col_type[i]);
-			if(comparer(tmp_index, buf + header.col_offset[i]) != 0)
-			{
-				first_not_conflicted = i;
-				break;
-			}
+			std::fprintf(stderr, "[Error] Primary key confliction with __rowid__ = %d\n", rid);
+			return false;
 		}
+	}
 
-		if(first_not_conflicted == -1)
+	if(batch)
+	{
+		auto &keys = batch->unique.at(first_primary);
+		auto pk = keys.find(std::string(buf + header.col_offset[first_primary],
+			header.col_length[first_primary]));
+		if(pk != keys.end())
 		{
-			std::fprintf(stderr, "[Error] Primary key confliction with __rowid__ = %d\n", rid);
+			std::fprintf(stderr, "[Error] Primary key confliction with __rowid__ = %d\n", pk->second);
 			return false;
-		} else if(first_not_conflicted == first_primary) {
-			return true;
 		}
 	}
 
@@ -657,10 +1775,10 @@ bool table_manager::check_notnull(const char *buf)
 	return true;
 }
 
-bool table_manager::check_value_constraint(const expr_node_t *expr)
+bool table_manager::check_value_constraint(const compiled_expr &expr)
 {
 	try {
-		return typecast::expr_to_bool(expression::eval(expr));
+		return expr.eval_bool();
 	} catch(const char *msg) {
 		std::puts(msg);
 		return false;
@@ -685,11 +1803,5 @@ bool table_manager::value_exists(const char *column, const char *key)
 		return false;
 	}
 
-	auto it = idx->get_iterator_lower_bound(key);
-	if(it.is_end()) return false;
-	record_manager rm = open_record_from_index_lower_bound(it.get());
-	auto comparer = get_index_comparer(get_column_type(cid));
-	rm.seek(header.col_offset[cid]);
-	rm.read(tmp_index, header.col_length[cid]);
-	return comparer(key, tmp_index) == 0;
+	return !idx->get_equal_iterator(key).is_end();
 }
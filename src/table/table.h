@@ -3,15 +3,25 @@
 
 #include <stdint.h>
 #include <fstream>
+#include <functional>
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "../defs.h"
 #include "../btree/btree.h"
 #include "../btree/iterator.h"
 #include "../index/index.h"
+#include "../index/bitmap_index.h"
+#include "../index/trigram_index.h"
+#include "../expression/compiled_expr.h"
 #include "table_header.h"
 #include "record.h"
+#include "row_format.h"
+#include "row_view.h"
+#include "zone_map.h"
+#include "column_cache.h"
 
 /*    Data page structure for rows
  *  | rid (main index) | notnull | fixed col 1 | ... | fixed col n |
@@ -24,28 +34,69 @@ class table_manager
 	table_header_t header;
 	std::shared_ptr<int_btree> btr;
 	std::shared_ptr<pager> pg;
+	std::shared_ptr<zone_map> zones;
+	// column segments of the hot data leaves
+	std::shared_ptr<column_cache> columns;
 	std::string tname;
 	index_manager *indices[MAX_COL_NUM];
+	index_manager *composite_indices[MAX_COMPOSITE_INDEX_NUM];
+	bitmap_index *bitmap_indices[MAX_COL_NUM];
+	trigram_index *trigram_indices[MAX_COL_NUM];
+	dictionary *dicts[MAX_COL_NUM];
 	expr_node_t *check_conds[MAX_CHECK_CONSTRAINT_NUM];
+	// compiled on the cached record
+	std::vector<compiled_expr> check_exprs;
 	const char *error_msg;
 
 	int tmp_record_size;
+	// bytes of the stored records read by cache_record, 0 for all
+	int cached_size;
+	// columns read by cache_record
+	uint32_t cached_cols;
+	row_format format;
 	char *tmp_record;
-	char *tmp_cache, *tmp_index;
+	char *tmp_cache, *tmp_index, *tmp_payload, *tmp_key;
+	// stored records
+	char *tmp_stored, *tmp_row;
 	int *tmp_null_mark;
+	// the cached record, seen by expressions
+	row_view row;
 	void allocate_temp_record();
+	void open_zone_map();
+	void open_column_cache();
 	void load_indices();
+	index_manager *open_index(int cid);
+	bitmap_index *open_bitmap_index(int cid);
+	trigram_index *open_trigram_index(int cid);
+	void index_existing_records_bitmap(int cid);
+	void index_existing_records_trigram(int cid);
+	void mark_bitmap_indices_stale();
+	int get_index_payload_size(int cid);
+	const char *fill_index_payload(int cid, const char *buf);
+	void index_existing_records(int cid);
+	index_manager *open_composite_index(int idx);
+	void index_existing_records_composite(int idx);
+	void analyze_composite_index(int idx);
+	void open_bloom_filters();
+	void rebuild_bloom_filters();
+	int count_records();
 	void free_indices();
+	void load_dictionaries();
+	void free_dictionaries();
+	// the codes of the columns with a dictionary, adding new strings
+	void encode_columns(const char *record, int *codes);
 	void load_check_constraints();
 	void free_check_constraints();
 public:
-	table_manager() : is_open(false), tmp_record(nullptr) { }
+	table_manager() : is_open(false), tmp_record(nullptr) { row.set_format(&header, &format); }
 	~table_manager() { if(is_open) close(); }
 	bool create(const char *table_name, const table_header_t *header);
 	bool open(const char *table_name);
 	void drop();
 	void close();
 	std::shared_ptr<table_manager> mirror(const char *alias_name);
+	// whether the index pages can hold the entries of this size
+	static bool index_entry_fits(int key_size, int payload_size);
 
 	int lookup_column(const char *col_name);
 	int get_column_offset(int col) { return header.col_offset[col]; }
@@ -53,28 +104,85 @@ public:
 	const char* get_column_name(int col) { return header.col_name[col]; }
 	uint8_t get_column_type(int col) { return header.col_type[col]; }
 	int get_column_num() { return header.col_num; }
+	int get_record_size() { return tmp_record_size; }
 	const char *get_table_name() { return header.table_name; }
-	void dump_table_info() { header.dump(); }
+	void dump_table_info();
 
 	void init_temp_record();
+	std::string get_temp_record() { return std::string(tmp_record, tmp_record_size); }
 	int insert_record();
+	/* insert records laid out as the temp record in a batch, and return
+	 * the number inserted. The rid of each record is filled, which is
+	 * 0 if the record breaks the constraints. */
+	int insert_records(std::vector<std::string> &records);
 	bool remove_record(int rid);
-	bool modify_record(int rid, int col, const void* data);
+	// remove the records in a batch, return the number removed
+	int remove_records(std::vector<int> rids);
+	/* modify the columns `cols' of the records in a batch, return the
+	 * number modified. Each record is cached, then `fill' sets the new
+	 * values in the temp record, or returns false to stop. */
+	int modify_records(std::vector<int> rids, uint32_t cols,
+			const std::function<bool()> &fill);
+	// false if a string is longer than the column
 	bool set_temp_record(int col, const void* data);
 
 	void cache_record(record_manager *rm);
 	const char* get_cached_column(int cid);
+	expression get_cached_expr(int cid) { return row.get_expr(cid); }
+	// the cached record, to which compiled expressions are bound
+	const row_view *get_row() { return &row; }
+	void release_row() { row.release(); }
+	// read a record into `buf' in the fixed layout, return its stored size
+	int read_record(record_manager *rm, char *buf);
+	/* only the columns in `cols' are read by cache_record, the others
+	 * of the cached record are undefined; all columns by default */
+	void set_cached_columns(uint32_t cols);
 
-	void create_index(const char *col_name);
+	void create_index(const char *col_name, uint32_t include = 0, bool use_hash = false);
 	bool has_index(const char *col_name);
 	bool has_index(int cid);
 	index_manager *get_index(int cid);
+	// bitmap index for low-cardinality columns
+	bool create_bitmap_index(const char *col_name);
+	bitmap_index *get_bitmap_index(int cid);
+	// trigram index for LIKE on VARCHAR columns
+	bool create_trigram_index(const char *col_name);
+	trigram_index *get_trigram_index(int cid);
+	// dictionary of a VARCHAR column declared with DICTIONARY, or nullptr
+	dictionary *get_dictionary(int cid) { return dicts[cid]; }
+	// the code of a column with a dictionary in a stored record, -1 for NULL
+	int read_code(record_manager *rm, int cid);
+	// columns which can be read from the index of `cid` without the record
+	uint32_t get_index_covered(int cid);
 	record_manager open_record_from_index_lower_bound(std::pair<int, int> idx_pos, int *rid = nullptr);
+	void cache_record_from_index(int cid, std::pair<int, int> idx_pos, int *rid = nullptr);
+
+	// composite indices, keys are normalized (see utils/key_encoder.h)
+	bool create_composite_index(const std::vector<int> &cols);
+	int get_composite_index_num() { return header.composite_index_num; }
+	int get_composite_col_num(int idx) { return header.composite_col_num[idx]; }
+	int get_composite_col(int idx, int i) { return header.composite_cols[idx][i]; }
+	index_manager *get_composite_index(int idx) { return composite_indices[idx]; }
+	int get_composite_key_size(int idx);
+	// distinct values of the leading column, up to SKIP_SCAN_MAX_GROUPS + 1
+	int get_composite_lead_ndv(int idx);
+	void fill_composite_key(int idx, const char *buf, char *dest);
 	bool value_exists(const char *column, const char *key);
 
 	// get the record R such that R.rid = min_{r.rid >= rid} r.rid
 	record_manager get_record_ptr_lower_bound(int rid, bool dirty=false);
 	btree_iterator<int_btree::leaf_page> get_record_iterator_lower_bound(int rid);
+	// move `it' to the record R.rid = rid, reusing the current leaf or the
+	// next one if possible; return false if no such record
+	bool seek_record_iterator(btree_iterator<int_btree::leaf_page> &it, int rid);
+	// INT, FLOAT and DATE columns have zone maps
+	bool has_zone_map(int cid) { return zones->is_tracked(cid); }
+	// false if no record of the data leaf `pid' can match all the conditions
+	bool leaf_may_match(int pid, const std::vector<zone_map::cond_t> &conds);
+	/* select the records of the data leaf `pid' matching all the conditions
+	 * by its column segments; false if the leaf is not cached */
+	bool select_leaf(int pid, const std::vector<zone_map::cond_t> &conds,
+			column_cache::selection_t &sel);
 	// get the record R such that R.rid = rid
 	record_manager get_record_ptr(int rid, bool dirty=false);
 
@@ -83,13 +191,32 @@ public:
 	void dump_record(FILE *f, record_manager *rm, std::vector<std::string>& row_);
 
 private:
-	bool check_constraints(const char *buf);
-	bool check_unique(const char *buf, int col);
-	bool check_primary(const char *buf);
-	bool check_foreign(const char *buf, int key_id);
+	/* Keys of the records accepted by insert_records, which are not in
+	 * the indices yet, and the foreign keys found in the parent tables. */
+	struct insert_batch_t
+	{
+		typedef std::map<std::string, int,
+			std::function<bool(const std::string&, const std::string&)>> key_map;
+		std::map<int, key_map> unique;
+		std::map<std::string, int> composite_primary;
+		std::vector<key_map> foreign;
+	};
+
+	// keys of column `cid', compared as in its index
+	insert_batch_t::key_map make_key_map(int cid);
+	bool check_constraints(const char *buf, insert_batch_t *batch = nullptr);
+	bool check_unique(const char *buf, int col, insert_batch_t *batch);
+	bool check_primary(const char *buf, insert_batch_t *batch);
+	bool check_foreign(const char *buf, int key_id, insert_batch_t *batch);
 	bool check_notnull(const char *buf);
-	bool check_value_constraint(const expr_node_t *expr);
-	void cache_record_from_tmp_cache();
+	bool check_value_constraint(const compiled_expr &expr);
+	void cache_row(const char *record, bool stored, int pid = 0);
+	// set the columns `cols' of a record to those of the temp record
+	bool modify_record(record_manager *rm, uint32_t cols, bool &moved);
+	// read a stored record, return its size
+	int read_stored(record_manager *rm, char *buf);
+	// read the prefix and the VARCHAR columns `cols' of a stored record
+	void read_columns(record_manager *rm, char *buf, uint32_t cols);
 };
 
 #endif
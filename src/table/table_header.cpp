@@ -2,7 +2,9 @@
 #include <cstdio>
 #include <sstream>
 #include "table_header.h"
+#include "table.h"
 #include "../utils/type_cast.h"
+#include "../utils/key_encoder.h"
 #include "../expression/expression.h"
 #include "../parser/defs.h"
 
@@ -47,6 +49,16 @@ bool fill_table_header(table_header_t *header, const table_def_t *table)
 			header->flag_primary |= 1 << index;
 		if(field->flags & FIELD_FLAG_UNIQUE)
 			header->flag_unique |= 1 << index;
+		if(field->flags & FIELD_FLAG_DICTIONARY)
+		{
+			if(header->col_type[index] != COL_TYPE_VARCHAR)
+			{
+				std::fprintf(stderr, "[Error] DICTIONARY is only for VARCHAR columns.\n");
+				return false;
+			}
+
+			header->flag_dictionary |= 1 << index;
+		}
 		if(field->default_value != nullptr)
 		{
 			if(header->col_length[index] > MAX_DEFAULT_LEN)
@@ -68,6 +80,20 @@ bool fill_table_header(table_header_t *header, const table_def_t *table)
 		}
 	}
 
+	// the VARCHAR bytes of stored records have 16-bit offsets
+	int varchar_size = 0;
+	for(int i = 0; i != header->col_num; ++i)
+	{
+		if(header->col_type[i] == COL_TYPE_VARCHAR && !((header->flag_dictionary >> i) & 1))
+			varchar_size += header->col_length[i];
+	}
+
+	if(varchar_size > MAX_VARCHAR_SIZE)
+	{
+		std::fprintf(stderr, "[Error] VARCHAR columns too long.\n");
+		return false;
+	}
+
 	auto lookup_column = [&](const char *name) -> int {
 		for(int i = 0; i != header->col_num; ++i)
 		{
@@ -155,12 +181,49 @@ bool fill_table_header(table_header_t *header, const table_def_t *table)
 		if(header->flag_primary & (1u << i))
 			++header->primary_key_num;
 
+	// composite index for multi-column primary key
+	if(header->primary_key_num > 1)
+	{
+		if(header->primary_key_num > MAX_COMPOSITE_INDEX_COL)
+		{
+			std::fprintf(stderr, "[Error] Too many primary key columns.\n");
+			return false;
+		}
+
+		// in declaration order, columns are stored reversed
+		for(int i = header->col_num - 1; i >= 0; --i)
+		{
+			if(header->flag_primary & (1u << i))
+				header->composite_cols[0][header->composite_col_num[0]++] = i;
+		}
+
+		header->composite_index_num = 1;
+		header->composite_flag_primary = 1;
+
+		int key_size = 0;
+		for(int i = 0; i != header->composite_col_num[0]; ++i)
+			key_size += sortable_key_length(header->col_length[header->composite_cols[0][i]]);
+		if(!table_manager::index_entry_fits(key_size, 0))
+		{
+			std::fprintf(stderr, "[Error] primary key too large.\n");
+			return false;
+		}
+	}
+
+	for(int i = 0; i != header->col_num; ++i)
+	{
+		if(((header->flag_indexed >> i) & 1) && !table_manager::index_entry_fits(header->col_length[i], 0))
+		{
+			std::fprintf(stderr, "[Error] index entry of column `%s` too large.\n", header->col_name[i]);
+			return false;
+		}
+	}
+
 	return true;
 }
 
 void table_header_t::dump()
 {
-	std::printf("======== Table Info Begin ========\n");
 	std::printf("Table name  = %s\n", table_name);
 	std::printf("Column size = %d\n", col_num);
 	std::printf("Record size = %d\n", records_num);
@@ -195,9 +258,38 @@ void table_header_t::dump()
 			std::printf("UNIQUE ");
 		if(flag_indexed & (1 << i))
 			std::printf("INDEXED ");
+		if(flag_hash_index & (1 << i))
+			std::printf("HASH ");
+		if(flag_bitmap_index & (1 << i))
+			std::printf("BITMAP ");
+		if(flag_trigram_index & (1 << i))
+			std::printf("TRIGRAM ");
+		if(flag_dictionary & (1 << i))
+			std::printf("DICTIONARY ");
 		std::puts("");
 	}
 
+	for(int i = 0; i != col_num; ++i)
+	{
+		if(!index_include[i]) continue;
+		std::printf("  [index] %s include (", col_name[i]);
+		for(int j = 0, first = 1; j != col_num; ++j)
+		{
+			if(!(index_include[i] & (1u << j))) continue;
+			std::printf(first ? "%s" : ", %s", col_name[j]);
+			first = 0;
+		}
+		std::puts(")");
+	}
+
+	for(int i = 0; i != composite_index_num; ++i)
+	{
+		std::printf("  [index] (");
+		for(int j = 0; j != composite_col_num[i]; ++j)
+			std::printf(j ? ", %s" : "%s", col_name[composite_cols[i][j]]);
+		std::puts((composite_flag_primary & (1u << i)) ? ") PRIMARY" : ")");
+	}
+
 	for(int i = 0; i != foreign_key_num; ++i)
 	{
 		std::printf("  [foreign key] %s references %s.%s\n",
@@ -206,6 +298,4 @@ void table_header_t::dump()
 			foreign_key_ref_column[i]
 		);
 	}
-
-	std::printf("======== Table Info End   ========\n");
 }
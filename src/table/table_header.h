@@ -12,6 +12,14 @@ struct table_header_t
 
 	int records_num, primary_key_num, check_constaint_num, foreign_key_num;
 	uint32_t flag_notnull, flag_primary, flag_indexed, flag_unique, flag_default;
+	// indexed columns using hash index instead of b-tree
+	uint32_t flag_hash_index;
+	// columns having a bitmap index (kept apart from flag_indexed)
+	uint32_t flag_bitmap_index;
+	// VARCHAR columns having a trigram index for LIKE
+	uint32_t flag_trigram_index;
+	// VARCHAR columns stored as codes of a dictionary
+	uint32_t flag_dictionary;
 	uint8_t col_type[MAX_COL_NUM];
 
 	// the length of columns
@@ -20,6 +28,26 @@ struct table_header_t
 	int col_offset[MAX_COL_NUM];
 	// root page of index, 0 if no index
 	int index_root[MAX_COL_NUM];
+	// root page of bloom filter of index, 0 if not built yet
+	int bloom_root[MAX_COL_NUM];
+	// root page of bitmap index
+	int bitmap_root[MAX_COL_NUM];
+	// root page of trigram index
+	int trigram_root[MAX_COL_NUM];
+	// root page of dictionary
+	int dict_root[MAX_COL_NUM];
+	// columns stored in the index entries (INCLUDE), for index-only scans
+	uint32_t index_include[MAX_COL_NUM];
+	// composite indices over an ordered list of columns
+	int composite_index_num;
+	uint32_t composite_flag_primary;
+	uint8_t composite_col_num[MAX_COMPOSITE_INDEX_NUM];
+	uint8_t composite_cols[MAX_COMPOSITE_INDEX_NUM][MAX_COMPOSITE_INDEX_COL];
+	int composite_root[MAX_COMPOSITE_INDEX_NUM];
+	int composite_bloom_root[MAX_COMPOSITE_INDEX_NUM];
+	// distinct values of the leading column, up to SKIP_SCAN_MAX_GROUPS + 1,
+	// or -1 if the index has changed since counted
+	int composite_lead_ndv[MAX_COMPOSITE_INDEX_NUM];
 	// auto increment counter
 	int64_t auto_inc;
 
@@ -0,0 +1,100 @@
+#include "zone_map.h"
+#include "../defs.h"
+
+zone_map::zone_map(const std::vector<int> &types, const std::vector<int> &offsets)
+	: col_index(types.size(), -1)
+{
+	for(size_t cid = 0; cid != types.size(); ++cid)
+	{
+		int type = types[cid];
+		if(type != COL_TYPE_INT && type != COL_TYPE_FLOAT && type != COL_TYPE_DATE)
+			continue;
+		col_index[cid] = cols.size();
+		cols.push_back({ (int)cid, type, offsets[cid] });
+	}
+}
+
+int zone_map::compare(int idx, value_t a, value_t b)
+{
+	if(cols[idx].type == COL_TYPE_FLOAT)
+		return a.f < b.f ? -1 : (a.f > b.f ? 1 : 0);
+	return a.i < b.i ? -1 : (a.i > b.i ? 1 : 0);
+}
+
+const zone_map::zone_t *zone_map::find(int pid, uint32_t version)
+{
+	auto it = zones.find(pid);
+	if(it == zones.end()) return nullptr;
+	if(it->second.version != version)
+	{
+		zones.erase(it);
+		return nullptr;
+	}
+
+	return &it->second;
+}
+
+zone_map::zone_t &zone_map::reset(int pid, uint32_t version)
+{
+	zone_t &zone = zones[pid];
+	zone.version = version;
+	zone.has_value = 0;
+	zone.lo.resize(cols.size());
+	zone.hi.resize(cols.size());
+	return zone;
+}
+
+void zone_map::add(zone_t &zone, const char *record)
+{
+	int null_mark = ((const int*)record)[1];
+	for(size_t i = 0; i != cols.size(); ++i)
+	{
+		const column_t &col = cols[i];
+		if((null_mark >> col.cid) & 1)
+			continue;
+
+		value_t val = *(const value_t*)(record + col.offset);
+		if(!(zone.has_value & (1u << i)))
+		{
+			zone.has_value |= 1u << i;
+			zone.lo[i] = zone.hi[i] = val;
+		} else if(compare(i, val, zone.lo[i]) < 0) {
+			zone.lo[i] = val;
+		} else if(compare(i, val, zone.hi[i]) > 0) {
+			zone.hi[i] = val;
+		}
+	}
+}
+
+void zone_map::widen(int pid, uint32_t version, const char *record)
+{
+	if(zones.empty()) return;
+	auto it = zones.find(pid);
+	if(it != zones.end() && it->second.version == version)
+		add(it->second, record);
+}
+
+bool zone_map::may_match(const zone_t &zone, const std::vector<cond_t> &conds)
+{
+	for(const cond_t &cond : conds)
+	{
+		int idx = col_index[cond.cid];
+		// comparisons with NULL are never true
+		if(!(zone.has_value & (1u << idx)))
+			return false;
+
+		int lo = compare(idx, zone.lo[idx], cond.val);
+		int hi = compare(idx, zone.hi[idx], cond.val);
+		switch(cond.op)
+		{
+			case OPERATOR_EQ:  if(lo > 0 || hi < 0) return false; break;
+			case OPERATOR_LT:  if(lo >= 0) return false; break;
+			case OPERATOR_LEQ: if(lo > 0) return false; break;
+			case OPERATOR_GT:  if(hi <= 0) return false; break;
+			case OPERATOR_GEQ: if(hi < 0) return false; break;
+			default: break;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,68 @@
+#ifndef __TRIVIALDB_ZONE_MAP__
+#define __TRIVIALDB_ZONE_MAP__
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "../parser/defs.h"
+
+/* Zone maps of the data leaves.
+ * For each leaf of the data b-tree, the smallest and the largest non-NULL
+ * value of each INT, FLOAT and DATE column are kept in memory, together
+ * with the version of the page in the b-tree. Splits and merges bump the
+ * version, which drops the zone; inserts and updates widen it, and
+ * removals leave it wider than needed, which is harmless. Zones are built
+ * when a leaf is scanned without one. Records are in the stored layout
+ * (see row_format.h), where the tracked columns are at fixed offsets. */
+
+class zone_map
+{
+public:
+	union value_t
+	{
+		int i;
+		float f;
+	};
+
+	// `column op value', where the column is one of the table
+	struct cond_t
+	{
+		int cid;
+		operator_type_t op;
+		value_t val;
+	};
+
+	struct zone_t
+	{
+		uint32_t version;
+		uint32_t has_value;  // columns with non-NULL values
+		std::vector<value_t> lo, hi;
+	};
+
+private:
+	struct column_t
+	{
+		int cid, type, offset;
+	};
+
+	std::vector<column_t> cols;
+	std::vector<int> col_index;  // index in `cols' of each column, or -1
+	std::unordered_map<int, zone_t> zones;
+
+	int compare(int idx, value_t a, value_t b);
+
+public:
+	zone_map(const std::vector<int> &types, const std::vector<int> &offsets);
+
+	bool is_tracked(int cid) { return col_index[cid] >= 0; }
+	// the zone of a leaf, or nullptr if there is none for this version
+	const zone_t *find(int pid, uint32_t version);
+	// start an empty zone of a leaf, to which its records are added
+	zone_t &reset(int pid, uint32_t version);
+	void add(zone_t &zone, const char *record);
+	// widen the zone of a leaf, if any, by a record written to it
+	void widen(int pid, uint32_t version, const char *record);
+	bool may_match(const zone_t &zone, const std::vector<cond_t> &conds);
+	void clear() { zones.clear(); }
+};
+
+#endif
@@ -50,7 +50,7 @@ inline int strcasecmp(const char *s1, const char *s2)
 	}
 }
 
-inline bool strlike(const char *s1, const char *s2)
+inline std::string like_to_regex(const char *s2)
 {
 	// See: https://docs.microsoft.com/en-us/sql/t-sql/language-elements/like-transact-sql?view=sql-server-2017
 	enum {
@@ -97,7 +97,23 @@ inline bool strlike(const char *s1, const char *s2)
 		}
 	}
 
-	return std::regex_match(s1, std::regex(pattern));
+	return pattern;
+}
+
+inline bool strlike(const char *s1, const char *s2)
+{
+	// the same pattern is matched against every row of a scan
+	thread_local std::string last_pattern;
+	thread_local std::regex regex;
+	thread_local bool compiled = false;
+	if(!compiled || last_pattern != s2)
+	{
+		regex = std::regex(like_to_regex(s2));
+		last_pattern = s2;
+		compiled = true;
+	}
+
+	return std::regex_match(s1, regex);
 }
 
 #endif
@@ -0,0 +1,43 @@
+#ifndef __TRIVIALDB_HASHER__
+#define __TRIVIALDB_HASHER__
+
+#include <cstring>
+#include <stdint.h>
+
+// FNV-1a, followed by the finalizer of murmur3 to spread the low bits
+inline uint32_t bytes_hasher(const char *data, int len)
+{
+	uint32_t h = 2166136261u;
+	for(int i = 0; i != len; ++i)
+	{
+		h ^= (uint8_t)data[i];
+		h *= 16777619u;
+	}
+
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35u;
+	h ^= h >> 16;
+	return h;
+}
+
+inline uint32_t integer_bin_hasher(const char *x, int)
+{
+	return bytes_hasher(x, 4);
+}
+
+inline uint32_t float_bin_hasher(const char *x, int)
+{
+	float f;
+	std::memcpy(&f, x, 4);
+	if(f == 0) f = 0;  // -0.0 == 0.0
+	return bytes_hasher((const char*)&f, 4);
+}
+
+inline uint32_t string_hasher(const char *x, int size)
+{
+	return bytes_hasher(x, strnlen(x, size));
+}
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef __TRIVIALDB_KEY_ENCODER__
+#define __TRIVIALDB_KEY_ENCODER__
+
+#include <cstring>
+#include <stdint.h>
+#include "../defs.h"
+
+/* Normalized keys for composite indices.
+ *
+ * Each column is encoded as | notnull (1 byte) | value (col length) |
+ * such that comparing two encoded keys with memcmp gives the same
+ * order as comparing the values column by column (NULL first).
+ */
+
+inline int sortable_key_length(int col_length)
+{
+	return col_length + 1;
+}
+
+inline void encode_sortable_key(int type, int col_length, const char *data, char *dest)
+{
+	if(data == nullptr)
+	{
+		std::memset(dest, 0, col_length + 1);
+		return;
+	}
+
+	*dest++ = 1;
+	uint32_t v;
+	switch(type)
+	{
+		case COL_TYPE_INT:
+		case COL_TYPE_DATE:
+			std::memcpy(&v, data, 4);
+			v ^= 0x80000000u;
+			break;
+		case COL_TYPE_FLOAT: {
+			float f;
+			std::memcpy(&f, data, 4);
+			if(f == 0) f = 0;  // -0.0 == 0.0
+			std::memcpy(&v, &f, 4);
+			v = (v & 0x80000000u) ? ~v : (v | 0x80000000u);
+			break; }
+		case COL_TYPE_VARCHAR:
+			// zero padded string, the last byte is always zero
+			std::strncpy(dest, data, col_length - 1);
+			dest[col_length - 1] = 0;
+			return;
+		default:
+			std::memcpy(dest, data, col_length);
+			return;
+	}
+
+	// big endian
+	dest[0] = (char)(v >> 24);
+	dest[1] = (char)(v >> 16);
+	dest[2] = (char)(v >> 8);
+	dest[3] = (char)v;
+}
+
+#endif
@@ -0,0 +1,49 @@
+CREATE DATABASE db;
+
+USE db;
+
+CREATE TABLE Parts (
+   PartID int,
+   Name varchar(8),
+   PRIMARY KEY (PartID));
+
+INSERT INTO Parts VALUES
+(1, 'bolt'),
+(2, 'nut'),
+(1, 'screw'),
+(3, 'washer');
+
+CREATE TABLE Orders (
+   OrderID int,
+   PartID int,
+   Qty int,
+   CHECK (Qty > 0),
+   FOREIGN KEY (PartID) REFERENCES Parts(PartID),
+   PRIMARY KEY (OrderID));
+
+INSERT INTO Orders VALUES
+(1, 1, 5),
+(2, 1, 6),
+(3, 9, 1),
+(4, 2, 0),
+(5, 2, 3),
+(5, 3, 2),
+(6, 1, 2);
+
+CREATE TABLE Stock (
+   PartID int,
+   Bin int,
+   Qty int,
+   PRIMARY KEY (PartID),
+   PRIMARY KEY (Bin));
+
+INSERT INTO Stock VALUES
+(1, 1, 10),
+(1, 2, 20),
+(1, 1, 30),
+(2, 1, 40);
+
+SELECT * FROM Parts;
+SELECT * FROM Orders;
+SELECT * FROM Stock;
+SELECT * FROM Orders WHERE PartID = 1;
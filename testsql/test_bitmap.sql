@@ -0,0 +1,29 @@
+CREATE DATABASE db;
+
+USE db;
+
+CREATE TABLE Books (
+   BookID int,
+   Author varchar(32),
+   Year int,
+   Lang varchar(8),
+   PRIMARY KEY (BookID));
+
+CREATE INDEX Books(Author);
+CREATE INDEX Books(Year);
+CREATE INDEX Books(Lang) USING HASH;
+
+INSERT INTO Books VALUES
+(1, 'Knuth', 1968, 'en'),
+(2, 'Knuth', 1969, 'en'),
+(3, 'Wirth', 1976, 'en'),
+(4, 'Dijkstra', 1976, 'nl'),
+(5, 'Knuth', 1976, 'de'),
+(6, 'Hoare', 1985, 'en');
+
+SELECT * FROM Books WHERE Author = 'Knuth' AND Year = 1976;
+SELECT * FROM Books WHERE Author = 'Wirth' OR Lang = 'nl';
+SELECT * FROM Books WHERE Year IN (1968, 1985) OR Lang = 'de';
+SELECT * FROM Books WHERE (Author = 'Knuth' OR Author = 'Hoare') AND Lang = 'en';
+DELETE FROM Books WHERE Author = 'Hoare' OR Year = 1969;
+SELECT * FROM Books;
@@ -0,0 +1,39 @@
+CREATE DATABASE db;
+
+USE db;
+
+CREATE TABLE Orders (
+   OrderID int,
+   Status varchar(16),
+   Priority int,
+   Amount int,
+   PRIMARY KEY (OrderID));
+
+INSERT INTO Orders VALUES
+(1, 'open', 1, 100),
+(2, 'shipped', 2, 250),
+(3, 'open', 2, 80),
+(4, 'cancelled', 3, 40),
+(5, 'shipped', 1, 300),
+(6, NULL, 1, 10);
+
+CREATE BITMAP INDEX Orders(Status);
+CREATE BITMAP INDEX Orders(Priority);
+CREATE INDEX Orders(Status);
+
+SELECT * FROM Orders WHERE Status = 'open';
+SELECT COUNT(*) FROM Orders WHERE Status = 'shipped' AND Priority = 1;
+SELECT COUNT(*) FROM Orders WHERE Priority IN (1, 3);
+SELECT * FROM Orders WHERE Status = 'cancelled' OR Priority = 2;
+
+UPDATE Orders SET Status = 'shipped' WHERE OrderID = 3;
+DELETE FROM Orders WHERE OrderID = 5;
+INSERT INTO Orders VALUES (7, 'open', 3, 70);
+
+CREATE DATABASE other;
+USE other;
+USE db;
+
+SELECT * FROM Orders WHERE Status = 'shipped';
+SELECT COUNT(*) FROM Orders WHERE Status = 'open' AND Priority = 3;
+SELECT SUM(Amount) FROM Orders WHERE Priority = 1;
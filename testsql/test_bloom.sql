@@ -0,0 +1,39 @@
+CREATE DATABASE db;
+
+USE db;
+
+CREATE TABLE Users (
+   UserID int,
+   Email varchar(64),
+   PRIMARY KEY (UserID));
+
+CREATE INDEX Users(Email);
+
+INSERT INTO Users VALUES
+(1, 'ann@example.com'),
+(2, 'bob@example.com'),
+(3, 'cat@example.com');
+
+CREATE TABLE Logins (
+   UserID int,
+   At date,
+   FOREIGN KEY (UserID) REFERENCES Users(UserID));
+
+INSERT INTO Logins VALUES (1, '2018-11-01');
+INSERT INTO Logins VALUES (4, '2018-11-01');
+INSERT INTO Users VALUES (3, 'dan@example.com');
+INSERT INTO Users VALUES (4, 'dan@example.com');
+
+SELECT * FROM Users WHERE Email = 'eve@example.com';
+DELETE FROM Users WHERE UserID = 2;
+SELECT * FROM Users WHERE UserID = 2;
+INSERT INTO Users VALUES (2, 'bob@example.com');
+
+CREATE DATABASE other;
+USE other;
+USE db;
+
+SELECT * FROM Users WHERE Email = 'bob@example.com';
+INSERT INTO Logins VALUES (4, '2018-11-02');
+INSERT INTO Logins VALUES (5, '2018-11-02');
+SELECT * FROM Logins;
@@ -0,0 +1,85 @@
+CREATE DATABASE db_column;
+USE db_column;
+
+CREATE TABLE Sales (
+    SaleID int,
+    Region int,
+    Store int,
+    Amount float,
+    Qty int,
+    Day date,
+    Note varchar(40),
+    PRIMARY KEY (SaleID));
+
+LOAD DATA INFILE 'testsql/test_column_cache.csv' INTO TABLE Sales;
+
+SELECT COUNT(*) FROM Sales WHERE Region + 0 = 3;
+SELECT COUNT(*) FROM Sales WHERE Store + 0 = 7;
+SELECT COUNT(*) FROM Sales WHERE Store + 0 <> 7 AND Region + 0 < 2;
+SELECT COUNT(*) FROM Sales WHERE Qty + 0 >= 104000 AND Store + 0 = 11;
+SELECT COUNT(*) FROM Sales WHERE Amount + 0.0 = 18.5;
+SELECT COUNT(*) FROM Sales WHERE Amount + 0.0 > 400.0 AND Region + 0 >= 6;
+SELECT COUNT(*) FROM Sales WHERE Day = '2024-03-03';
+SELECT COUNT(*) FROM Sales WHERE Store IS NULL;
+SELECT COUNT(*) FROM Sales WHERE Region + 0 > 100;
+
+SELECT COUNT(*) FROM Sales WHERE Region = 3;
+SELECT COUNT(*) FROM Sales WHERE Store = 7;
+SELECT COUNT(*) FROM Sales WHERE Store <> 7 AND Region < 2;
+SELECT COUNT(*) FROM Sales WHERE Qty >= 104000 AND Store = 11;
+SELECT COUNT(*) FROM Sales WHERE Amount = 18.5;
+SELECT COUNT(*) FROM Sales WHERE Amount > 400.0 AND Region >= 6;
+SELECT COUNT(*) FROM Sales WHERE Day = '2024-03-03';
+SELECT COUNT(*) FROM Sales WHERE Store IS NULL;
+SELECT COUNT(*) FROM Sales WHERE Region > 100;
+
+SELECT COUNT(*) FROM Sales WHERE Region = 3;
+SELECT COUNT(*) FROM Sales WHERE Store = 7;
+SELECT COUNT(*) FROM Sales WHERE Store <> 7 AND Region < 2;
+SELECT COUNT(*) FROM Sales WHERE Qty >= 104000 AND Store = 11;
+SELECT COUNT(*) FROM Sales WHERE Amount = 18.5;
+SELECT COUNT(*) FROM Sales WHERE Amount > 400.0 AND Region >= 6;
+SELECT COUNT(*) FROM Sales WHERE Day = '2024-03-03';
+SELECT COUNT(*) FROM Sales WHERE Store IS NULL;
+SELECT COUNT(*) FROM Sales WHERE Region > 100;
+
+SELECT SaleID, Region, Store, Qty FROM Sales WHERE Store = 19 AND Region = 7;
+
+UPDATE Sales SET Store = 7 WHERE Region = 2;
+UPDATE Sales SET Note = 'a longer note moving the record' WHERE SaleID < 30;
+DELETE FROM Sales WHERE Store = 3;
+INSERT INTO Sales VALUES (1000, 3, 7, 18.5, 100001, '2024-03-03', 'new'), (1001, 9, NULL, 1.5, 99, '2024-01-01', 'new');
+
+SELECT COUNT(*) FROM Sales WHERE Region + 0 = 3;
+SELECT COUNT(*) FROM Sales WHERE Store + 0 = 7;
+SELECT COUNT(*) FROM Sales WHERE Store + 0 <> 7 AND Region + 0 < 2;
+SELECT COUNT(*) FROM Sales WHERE Qty + 0 >= 104000 AND Store + 0 = 11;
+SELECT COUNT(*) FROM Sales WHERE Amount + 0.0 = 18.5;
+SELECT COUNT(*) FROM Sales WHERE Amount + 0.0 > 400.0 AND Region + 0 >= 6;
+SELECT COUNT(*) FROM Sales WHERE Day = '2024-03-03';
+SELECT COUNT(*) FROM Sales WHERE Store IS NULL;
+SELECT COUNT(*) FROM Sales WHERE Region + 0 > 100;
+
+SELECT COUNT(*) FROM Sales WHERE Region = 3;
+SELECT COUNT(*) FROM Sales WHERE Store = 7;
+SELECT COUNT(*) FROM Sales WHERE Store <> 7 AND Region < 2;
+SELECT COUNT(*) FROM Sales WHERE Qty >= 104000 AND Store = 11;
+SELECT COUNT(*) FROM Sales WHERE Amount = 18.5;
+SELECT COUNT(*) FROM Sales WHERE Amount > 400.0 AND Region >= 6;
+SELECT COUNT(*) FROM Sales WHERE Day = '2024-03-03';
+SELECT COUNT(*) FROM Sales WHERE Store IS NULL;
+SELECT COUNT(*) FROM Sales WHERE Region > 100;
+
+SELECT COUNT(*) FROM Sales WHERE Region = 3;
+SELECT COUNT(*) FROM Sales WHERE Store = 7;
+SELECT COUNT(*) FROM Sales WHERE Store <> 7 AND Region < 2;
+SELECT COUNT(*) FROM Sales WHERE Qty >= 104000 AND Store = 11;
+SELECT COUNT(*) FROM Sales WHERE Amount = 18.5;
+SELECT COUNT(*) FROM Sales WHERE Amount > 400.0 AND Region >= 6;
+SELECT COUNT(*) FROM Sales WHERE Day = '2024-03-03';
+SELECT COUNT(*) FROM Sales WHERE Store IS NULL;
+SELECT COUNT(*) FROM Sales WHERE Region > 100;
+
+DELETE FROM Sales WHERE SaleID > 0;
+SELECT COUNT(*) FROM Sales WHERE Region = 3;
+SELECT COUNT(*) FROM Sales WHERE Region = 3;
@@ -0,0 +1,42 @@
+CREATE DATABASE db;
+
+USE db;
+
+CREATE TABLE Scores (
+   StudentID int,
+   CourseID int,
+   Term varchar(10),
+   Score float,
+   PRIMARY KEY (StudentID),
+   PRIMARY KEY (CourseID));
+
+INSERT INTO Scores VALUES
+(1, 101, 'Spring', 90.5),
+(1, 102, 'Spring', 80),
+(2, 101, 'Fall', 70),
+(2, 103, 'Fall', 85.5),
+(3, 102, 'Spring', 60);
+
+INSERT INTO Scores VALUES (1, 101, 'Fall', 99);
+INSERT INTO Scores VALUES (3, 101, 'Fall', 75);
+
+SELECT * FROM Scores WHERE StudentID = 1 AND CourseID = 102;
+SELECT * FROM Scores WHERE StudentID = 2 AND CourseID >= 102;
+SELECT * FROM Scores WHERE CourseID < 102 AND StudentID = 1;
+
+CREATE INDEX Scores(Term, Score);
+SELECT * FROM Scores WHERE Term = 'Fall' AND Score > 72.0;
+SELECT * FROM Scores WHERE Term = 'Spring' AND Score <= 80.0;
+
+UPDATE Scores SET CourseID = 101 WHERE StudentID = 1 AND CourseID = 102;
+UPDATE Scores SET CourseID = 104 WHERE StudentID = 1 AND CourseID = 102;
+DELETE FROM Scores WHERE Term = 'Fall' AND Score = 70.0;
+SELECT * FROM Scores WHERE StudentID >= 1;
+INSERT INTO Scores VALUES (2, 101, 'Fall', 65);
+SELECT * FROM Scores WHERE StudentID = 2 AND CourseID = 101;
+
+CREATE TABLE Wide (
+   A varchar(1000),
+   B varchar(1000),
+   PRIMARY KEY (A),
+   PRIMARY KEY (B));
@@ -0,0 +1,39 @@
+CREATE DATABASE db;
+
+USE db;
+
+CREATE TABLE Items (
+   ItemID int,
+   Kind varchar(8),
+   Weight int,
+   Name varchar(16),
+   PRIMARY KEY (ItemID));
+
+INSERT INTO Items VALUES
+(1, 'tool', 30, 'hammer'),
+(2, 'tool', 12, 'wrench'),
+(3, 'food', 5, 'apple'),
+(4, 'food', 7, 'pear'),
+(5, 'toy', 20, 'yoyo'),
+(6, NULL, 9, 'spare hammer'),
+(7, 'tool', 15, 'saw'),
+(8, 'food', NULL, 'apple pie');
+
+CREATE INDEX Items(Weight);
+CREATE INDEX Items(Kind, Weight);
+CREATE BITMAP INDEX Items(Kind);
+CREATE INDEX Items(Name) USING TRIGRAM;
+
+DELETE FROM Items WHERE Weight < 10;
+DELETE FROM Items WHERE Weight IS NULL;
+
+SELECT * FROM Items;
+SELECT * FROM Items WHERE Weight > 12;
+SELECT COUNT(*) FROM Items WHERE Kind = 'tool';
+SELECT * FROM Items WHERE Name LIKE '%amm%';
+
+DELETE FROM Items WHERE Kind = 'tool';
+INSERT INTO Items VALUES (9, 'tool', 11, 'drill');
+
+SELECT * FROM Items;
+SELECT * FROM Items WHERE Kind = 'tool' AND Weight = 11;
@@ -0,0 +1,70 @@
+CREATE DATABASE db_dict;
+USE db_dict;
+
+CREATE TABLE Visits (
+    VisitID int,
+    City varchar(20) DICTIONARY,
+    Device varchar(10) NOT NULL DICTIONARY,
+    Note varchar(30),
+    Cost int,
+    PRIMARY KEY (VisitID));
+
+CREATE TABLE Bad (
+    ID int DICTIONARY,
+    PRIMARY KEY (ID));
+
+INSERT INTO Visits VALUES
+(1, 'Shenzhen', 'phone', 'note 1', 63),
+(2, 'Shenzhen', 'pc', 'note 2', 39),
+(3, 'Beijing', 'pc', NULL, 10),
+(4, 'Hangzhou', 'pc', 'note 4', 15),
+(5, 'beijing', 'pad', 'note 5', 40),
+(6, 'Shanghai', 'phone', 'note 6', 95),
+(7, NULL, 'pc', 'note 7', 55),
+(8, 'Chengdu', 'pad', 'note 8', 70),
+(9, 'Chengdu', 'phone', 'note 9', 20),
+(10, 'Hangzhou', 'pad', 'note 10', 99),
+(11, 'Shenzhen', 'pad', 'note 11', 91),
+(12, 'Beijing', 'phone', 'note 12', 5),
+(13, 'Chengdu', 'pc', 'note 13', 51),
+(14, 'Shanghai', 'pad', NULL, 30),
+(15, '', 'pc', 'note 15', 45),
+(16, 'Hangzhou', 'phone', 'note 16', 12);
+
+SELECT COUNT(*) FROM Visits WHERE City = 'Beijing';
+SELECT COUNT(*) FROM Visits WHERE City = 'BEIJING';
+SELECT COUNT(*) FROM Visits WHERE 'shanghai' = City;
+SELECT COUNT(*) FROM Visits WHERE City <> 'Shenzhen';
+SELECT COUNT(*) FROM Visits WHERE City LIKE 'Sh%';
+SELECT COUNT(*) FROM Visits WHERE City IN ('Hangzhou', 'beijing');
+SELECT COUNT(*) FROM Visits WHERE City IS NULL;
+SELECT COUNT(*) FROM Visits WHERE City = 'Wuhan';
+SELECT COUNT(*) FROM Visits WHERE City = 'Chengdu' AND Device = 'pad';
+SELECT COUNT(*) FROM Visits WHERE City = 'Chengdu' AND Cost > 50;
+SELECT COUNT(*) FROM Visits WHERE City = 'Chengdu' OR Device = 'pc';
+SELECT COUNT(*) FROM Visits WHERE City = 3;
+SELECT VisitID, City, Device, Cost FROM Visits WHERE City = 'Hangzhou' AND Cost < 20;
+SELECT * FROM Visits WHERE VisitID < 8;
+SHOW TABLE Visits;
+
+CREATE INDEX Visits (City);
+SELECT VisitID, Device FROM Visits WHERE City = 'Shenzhen' AND Cost > 90;
+DROP INDEX Visits (City);
+
+UPDATE Visits SET City = 'Wuhan' WHERE VisitID < 4;
+UPDATE Visits SET City = NULL WHERE VisitID = 9;
+UPDATE Visits SET Device = 'watch' WHERE City = 'Chengdu';
+INSERT INTO Visits VALUES (17, 'Xian', 'pc', 'new', 10), (18, 'Wuhan', 'tv', 'new', 20);
+DELETE FROM Visits WHERE City = 'Shenzhen';
+
+SELECT COUNT(*) FROM Visits WHERE City = 'Wuhan';
+SELECT COUNT(*) FROM Visits WHERE Device = 'watch';
+SELECT COUNT(*) FROM Visits WHERE City IN ('Xian', 'Shenzhen');
+SELECT COUNT(*) FROM Visits WHERE City LIKE '%u%' AND Device <> 'pc';
+SELECT VisitID, City, Device FROM Visits WHERE VisitID > 15 OR VisitID < 4;
+SELECT * FROM Visits WHERE VisitID = 9;
+
+USE db_dict;
+SELECT COUNT(*) FROM Visits WHERE City = 'xian' OR City = 'Hangzhou';
+INSERT INTO Visits VALUES (19, 'Xian', 'pc', 'again', 30);
+SELECT VisitID, City, Device, Note FROM Visits WHERE City = 'Xian';
@@ -0,0 +1,40 @@
+CREATE DATABASE db;
+
+USE db;
+
+CREATE TABLE Parts (
+   PartID int,
+   Name varchar(12),
+   Weight float,
+   Added date,
+   PRIMARY KEY (PartID));
+
+CREATE TABLE Copy (
+   PartID int,
+   Name varchar(12),
+   Weight float,
+   Added date,
+   PRIMARY KEY (PartID));
+
+INSERT INTO Parts VALUES
+(1, 'bolt', 0.5, '2020-01-02'),
+(2, 'nut, small', 0.1, '2020-02-28'),
+(3, 'say "hi"', NULL, NULL),
+(4, '', -2.25, '1999-12-31'),
+(5, '\N', 1000000.125, '2021-06-15'),
+(6, NULL, 3, '2020-01-02');
+
+SELECT * FROM Parts INTO OUTFILE 'test_export.csv';
+LOAD DATA INFILE 'test_export.csv' INTO TABLE Copy;
+SELECT * FROM Copy;
+
+SELECT PartID + 10, Name, Weight, Added FROM Parts WHERE PartID > 2 INTO OUTFILE 'test_export.tsv' FORMAT tsv;
+LOAD DATA INFILE 'test_export.tsv' INTO TABLE Copy FIELDS TERMINATED BY '\t';
+SELECT * FROM Copy WHERE PartID > 10;
+
+SELECT PartID, Weight FROM Parts INTO OUTFILE 'test_export.txt' FIELDS TERMINATED BY '|';
+SELECT * FROM Parts INTO OUTFILE 'test_export.bin' FORMAT binary;
+SELECT * FROM Parts INTO OUTFILE 'test_export.bin' FORMAT xml;
+SELECT COUNT(*) FROM Parts INTO OUTFILE 'test_export.csv';
+SELECT PartID, Name + Weight FROM Parts WHERE PartID >= 3 INTO OUTFILE 'test_export_err.csv';
+LOAD DATA INFILE 'test_export_err.csv' INTO TABLE Copy;
@@ -0,0 +1,43 @@
+CREATE DATABASE db;
+USE db;
+CREATE TABLE T (id int, a int, f float, s varchar(16), d date, CHECK (a < 100), PRIMARY KEY (id));
+CREATE TABLE U (id int, t_id int, name varchar(16));
+INSERT INTO T VALUES (1, 10, 1.5, 'apple', '2019-01-02'), (2, NULL, 2.5, 'Banana', '2020-03-04'), (3, 30, NULL, NULL, NULL), (4, -4, 0.0, 'cherry pie', '2018-12-31');
+INSERT INTO T VALUES (5, 200, 1.0, 'x', '2019-01-01');
+INSERT INTO U VALUES (1, 1, 'u1'), (2, 1, 'u2'), (3, 3, 'u3'), (4, 9, 'u4');
+CREATE INDEX U(t_id);
+SELECT * FROM T WHERE a + 1 > 10 AND f < 3.0;
+SELECT * FROM T WHERE a * 2 = 20 OR s = 'banana';
+SELECT * FROM T WHERE -a > 0;
+SELECT * FROM T WHERE a IS NULL;
+SELECT * FROM T WHERE s IS NOT NULL AND s LIKE '%an%';
+SELECT * FROM T WHERE a IN (10, 30, 5);
+SELECT * FROM T WHERE s IN ('apple', 'x', 'Banana');
+SELECT * FROM T WHERE f IN (1.5, 2.5);
+SELECT * FROM T WHERE d > '2019-01-01';
+SELECT * FROM T WHERE d IN ('2019-01-02', '2018-12-31');
+SELECT * FROM T WHERE a IN (10, 'x');
+SELECT * FROM T WHERE a = 'x';
+SELECT * FROM T WHERE a = 1 AND s = 3;
+SELECT * FROM T WHERE a > 100 AND s < 'x';
+SELECT * FROM T WHERE s < 'x';
+SELECT * FROM T WHERE nope = 1;
+SELECT * FROM T WHERE NOT a = 1;
+SELECT * FROM T WHERE a = NULL;
+SELECT * FROM T WHERE 1 = 1;
+SELECT * FROM T WHERE 1 = 2 AND a = 10;
+SELECT a + 1, f * 2.0, s FROM T;
+SELECT a / 2, -f FROM T WHERE a > 0;
+SELECT SUM(a) FROM T;
+SELECT AVG(f) FROM T WHERE f > 0.5;
+SELECT COUNT(*) FROM T WHERE a > 5;
+SELECT T.id, U.name FROM T, U WHERE T.id = U.t_id;
+SELECT T.id, U.name FROM T, U WHERE T.id = U.t_id AND U.name <> 'u2';
+SELECT T.id, U.name FROM T, U WHERE T.id = U.t_id AND id = 1;
+SELECT * FROM T, U WHERE T.a = U.id;
+UPDATE T SET a = a + 80 WHERE id < 3;
+UPDATE T SET a = a + 1, f = f + 1.0 WHERE s LIKE '%e%';
+UPDATE T SET s = 1 WHERE id = 1;
+SELECT * FROM T;
+DELETE FROM T WHERE a > 50 AND f > 2.0;
+SELECT * FROM T;
@@ -0,0 +1,30 @@
+CREATE DATABASE db_fragment;
+USE db_fragment;
+
+CREATE TABLE Notes (
+    NoteID int,
+    Body varchar(300),
+    Score int);
+
+LOAD DATA INFILE 'testsql/test_fragment.csv' INTO TABLE Notes;
+LOAD DATA INFILE 'testsql/test_fragment.csv' INTO TABLE Notes;
+LOAD DATA INFILE 'testsql/test_fragment.csv' INTO TABLE Notes;
+LOAD DATA INFILE 'testsql/test_fragment.csv' INTO TABLE Notes;
+LOAD DATA INFILE 'testsql/test_fragment.csv' INTO TABLE Notes;
+
+SHOW TABLE Notes;
+DELETE FROM Notes WHERE Score = 3 OR Score = 7;
+UPDATE Notes SET Body = 'short' WHERE Score = 1;
+UPDATE Notes SET Body = 'a longer body than before, which no longer fits in place' WHERE Score = 5;
+LOAD DATA INFILE 'testsql/test_fragment.csv' INTO TABLE Notes;
+
+DELETE FROM Notes WHERE NoteID > 10 AND NoteID < 50;
+UPDATE Notes SET Body = 'x' WHERE Score = 9;
+UPDATE Notes SET Score = 3 WHERE Score = 2;
+
+SELECT COUNT(*) FROM Notes;
+SELECT COUNT(*) FROM Notes WHERE Body = 'short';
+SELECT COUNT(*) FROM Notes WHERE Body LIKE 'a longer%';
+SELECT NoteID, Body FROM Notes WHERE NoteID < 6;
+SELECT COUNT(*) FROM Notes WHERE Score = 3;
+SHOW TABLE Notes;
@@ -0,0 +1,34 @@
+CREATE DATABASE db;
+
+USE db;
+
+CREATE TABLE Sessions (
+   Token varchar(32),
+   UserID int,
+   Created date);
+
+CREATE INDEX Sessions(Token) USING HASH;
+CREATE INDEX Sessions(UserID) INCLUDE (Created) USING HASH;
+
+INSERT INTO Sessions VALUES
+('a3f9c1', 1, '2018-10-01'),
+('77e0b2', 2, '2018-10-02'),
+('c81d4e', 1, '2018-10-03'),
+('9b2f70', 3, '2018-10-04');
+
+SHOW TABLE Sessions;
+
+SELECT * FROM Sessions WHERE Token = 'c81d4e';
+SELECT Created FROM Sessions WHERE UserID = 1;
+DELETE FROM Sessions WHERE Token = 'a3f9c1';
+UPDATE Sessions SET UserID = 2 WHERE Token = '9b2f70';
+SELECT Token FROM Sessions WHERE UserID = 2;
+
+CREATE TABLE Orders (
+   OrderID int,
+   Token varchar(32),
+   FOREIGN KEY (Token) REFERENCES Sessions(Token));
+
+INSERT INTO Orders VALUES (1, 'c81d4e');
+INSERT INTO Orders VALUES (2, 'a3f9c1');
+SELECT * FROM Orders, Sessions WHERE Orders.Token = Sessions.Token;
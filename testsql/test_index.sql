@@ -0,0 +1,32 @@
+CREATE DATABASE db;
+
+USE db;
+
+CREATE TABLE Persons (
+   PersonID int PRIMARY KEY,
+   LastName varchar(20),
+   FirstName varchar(20),
+   Age int,
+   City varchar(10));
+
+INSERT INTO Persons VALUES
+(1, 'Yi', 'Wang', 20, 'Beijing'),
+(2, 'Zhong', 'Lei', 31, 'Neijing'),
+(3, 'Wasserstein', 'Zhang', 25, 'Hunan');
+
+CREATE INDEX Persons(LastName) INCLUDE (Age, City);
+
+INSERT INTO Persons VALUES
+(4, 'Yi', 'Li', 42, 'Shanghai'),
+(5, 'Zhong', 'Wei', NULL, 'Tianjin');
+
+SELECT LastName, Age, City FROM Persons WHERE LastName = 'Yi';
+SELECT COUNT(*) FROM Persons WHERE LastName = 'Zhong';
+SELECT Age FROM Persons WHERE LastName = 'Zhong' AND Age > 30;
+SELECT FirstName FROM Persons WHERE LastName = 'Zhong';
+
+UPDATE Persons SET Age = 50 WHERE PersonID = 1;
+SELECT LastName, Age FROM Persons WHERE LastName = 'Yi';
+
+DELETE FROM Persons WHERE LastName = 'Yi' AND Age = 42;
+SELECT * FROM Persons;
@@ -0,0 +1,22 @@
+CREATE DATABASE db;
+
+USE db;
+
+CREATE TABLE Parts (
+   PartID int,
+   Name varchar(8),
+   Weight float,
+   Added date,
+   PRIMARY KEY (PartID));
+
+CREATE INDEX Parts(Name);
+
+LOAD DATA INFILE 'testsql/test_load.csv' INTO TABLE Parts;
+LOAD DATA INFILE 'testsql/test_load.tsv' INTO TABLE Parts FIELDS TERMINATED BY '\t' (PartID, Name);
+LOAD DATA INFILE 'testsql/missing.csv' INTO TABLE Parts;
+INSERT INTO Parts VALUES (7, 'toolongname12345', 3, '2020-03-05');
+
+SELECT * FROM Parts;
+SELECT * FROM Parts WHERE Name = 'bolt';
+SELECT * FROM Parts WHERE Weight IS NULL;
+SELECT * FROM Parts WHERE Added > '2020-01-01';
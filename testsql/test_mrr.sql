@@ -0,0 +1,24 @@
+CREATE DATABASE db;
+
+USE db;
+
+CREATE TABLE Readings (
+   Sensor int,
+   Value int);
+
+CREATE INDEX Readings(Sensor, Value);
+
+LOAD DATA INFILE 'testsql/test_mrr.csv' INTO TABLE Readings;
+LOAD DATA INFILE 'testsql/test_mrr.csv' INTO TABLE Readings;
+LOAD DATA INFILE 'testsql/test_mrr.csv' INTO TABLE Readings;
+LOAD DATA INFILE 'testsql/test_mrr.csv' INTO TABLE Readings;
+LOAD DATA INFILE 'testsql/test_mrr.csv' INTO TABLE Readings;
+LOAD DATA INFILE 'testsql/test_mrr.csv' INTO TABLE Readings;
+
+SELECT COUNT(*) FROM Readings WHERE Sensor = 1 AND Value >= 0;
+SELECT COUNT(*) FROM Readings WHERE Sensor + 0 = 1 AND Value + 0 >= 0;
+SELECT SUM(Value) FROM Readings WHERE Sensor = 1 AND Value >= 0;
+SELECT SUM(Value) FROM Readings WHERE Sensor + 0 = 1 AND Value + 0 >= 0;
+
+SELECT * FROM Readings WHERE Sensor = 0 AND Value < 12;
+SELECT * FROM Readings WHERE Sensor + 0 = 0 AND Value + 0 < 12;
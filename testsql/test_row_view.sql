@@ -0,0 +1,50 @@
+CREATE DATABASE db_row_view;
+USE db_row_view;
+
+CREATE TABLE Orders (
+    OrderID int,
+    CustomerID int,
+    Amount float,
+    Note varchar(40),
+    PRIMARY KEY (OrderID),
+    CHECK (Amount >= 0.0));
+
+CREATE TABLE Customers (
+    CustomerID int,
+    Name varchar(20),
+    Bio varchar(2000),
+    PRIMARY KEY (CustomerID));
+
+INSERT INTO Orders VALUES
+(1, 1, 1.5, 'order 1'),
+(2, 2, 32.5, 'order 2'),
+(3, 3, 3.5, 'order 3'),
+(4, 3, 40.5, NULL),
+(5, 0, 5.5, 'order 5'),
+(6, 1, 36.5, NULL),
+(7, 2, 7.5, 'order 7');
+
+INSERT INTO Customers VALUES
+(0, 'Customer0', 'bio 0'),
+(1, 'Customer1', NULL),
+(2, 'Customer2', 'bio 2 yyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyy'),
+(3, 'Customer3', 'bio 3');
+
+SELECT Orders.OrderID, Customers.Name FROM Orders, Customers
+    WHERE Orders.CustomerID = Customers.CustomerID AND Orders.Amount > 30.0;
+
+SELECT A.OrderID, B.OrderID FROM Orders AS A, Orders AS B
+    WHERE A.OrderID = B.CustomerID AND A.Note = 'order 3';
+
+SELECT Name FROM Customers WHERE Bio LIKE 'bio 2 %';
+SELECT Name FROM Customers WHERE Bio IS NULL;
+
+UPDATE Orders SET Amount = Amount - 20.0 WHERE CustomerID = 1;
+UPDATE Orders SET Amount = Amount - 20.0 WHERE CustomerID = 2;
+SELECT OrderID, Amount FROM Orders WHERE CustomerID = 2;
+
+UPDATE Orders SET Note = 'filled' WHERE Note IS NULL;
+SELECT OrderID, Note FROM Orders WHERE Note = 'filled';
+
+CREATE INDEX Orders(CustomerID) INCLUDE (Amount);
+SELECT CustomerID, Amount FROM Orders WHERE CustomerID = 3;
@@ -0,0 +1,37 @@
+CREATE DATABASE db;
+
+USE db;
+
+CREATE TABLE Sales (
+   SaleID int,
+   Region varchar(8),
+   Day int,
+   Amount int,
+   PRIMARY KEY (SaleID));
+
+INSERT INTO Sales VALUES
+(1, 'north', 1, 100),
+(2, 'south', 1, 200),
+(3, 'east', 2, 150),
+(4, 'north', 2, 120),
+(5, 'south', 3, 90),
+(6, NULL, 2, 60),
+(7, 'west', 5, 75);
+
+CREATE INDEX Sales(Region, Day);
+
+SELECT * FROM Sales WHERE Day = 2;
+SELECT * FROM Sales WHERE Day >= 3;
+SELECT SUM(Amount) FROM Sales WHERE Day = 1;
+SELECT * FROM Sales WHERE Region = 'north' AND Day = 2;
+
+CREATE TABLE Visits (
+   Site int,
+   Page int);
+
+CREATE INDEX Visits(Site, Page);
+
+INSERT INTO Visits VALUES (1, 1), (1, 2), (2, 2), (3, 1), (3, 2);
+SELECT * FROM Visits WHERE Page = 2;
+DELETE FROM Visits WHERE Site = 3;
+SELECT * FROM Visits WHERE Page = 2;
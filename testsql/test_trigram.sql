@@ -0,0 +1,44 @@
+CREATE DATABASE db;
+
+USE db;
+
+CREATE TABLE Articles (
+   ArticleID int,
+   Title varchar(64),
+   PRIMARY KEY (ArticleID));
+
+INSERT INTO Articles VALUES
+(1, 'Database System Concepts'),
+(2, 'Readings in Database Systems'),
+(3, 'The Art of Computer Programming'),
+(4, 'Transaction Processing'),
+(5, NULL);
+
+CREATE INDEX Articles(Title) USING TRIGRAM;
+
+SELECT * FROM Articles WHERE Title LIKE '%Database%';
+SELECT * FROM Articles WHERE Title LIKE '%Systems';
+SELECT * FROM Articles WHERE Title LIKE '%Pro_ramming%';
+SELECT * FROM Articles WHERE Title LIKE '%Art%' OR Title LIKE 'Trans%';
+SELECT * FROM Articles WHERE Title LIKE '%ing%' AND ArticleID > 2;
+
+INSERT INTO Articles VALUES
+(6, 'zzbzz'),
+(7, 'xxabcxx'),
+(8, 'xxabcyy'),
+(9, 'xyz');
+
+SELECT * FROM Articles WHERE Title LIKE '%[abc]%';
+SELECT * FROM Articles WHERE Title LIKE '%abcd*%';
+SELECT * FROM Articles WHERE Title LIKE '%abcx?%';
+SELECT * FROM Articles WHERE Title LIKE '%abcd|xyz%';
+
+UPDATE Articles SET Title = 'Database Internals' WHERE ArticleID = 3;
+DELETE FROM Articles WHERE ArticleID = 1;
+
+CREATE DATABASE other;
+USE other;
+USE db;
+
+SELECT * FROM Articles WHERE Title LIKE '%Database%';
+SELECT * FROM Articles WHERE Title LIKE '%Computer%';
@@ -0,0 +1,44 @@
+CREATE DATABASE db;
+
+USE db;
+
+CREATE TABLE Items (
+   ItemID int,
+   Kind varchar(8),
+   Weight int,
+   Price float,
+   Name varchar(32),
+   PRIMARY KEY (ItemID));
+
+INSERT INTO Items VALUES
+(1, 'tool', 30, 9.5, 'hammer'),
+(2, 'tool', 12, 4.0, 'wrench'),
+(3, 'food', 5, 1.5, 'apple'),
+(4, 'food', 7, 2.0, 'pear'),
+(5, 'toy', 20, 3.5, 'yoyo'),
+(6, NULL, 9, 1.0, 'spare hammer'),
+(7, 'tool', 15, 6.0, 'saw'),
+(8, 'food', NULL, 8.0, 'apple pie');
+
+CREATE INDEX Items(Weight);
+CREATE INDEX Items(Kind, Weight);
+CREATE BITMAP INDEX Items(Kind);
+CREATE INDEX Items(Name) USING TRIGRAM;
+
+UPDATE Items SET Weight = Weight + 1, Price = Price * 2.0 WHERE Kind = 'tool';
+UPDATE Items SET Name = 'a much longer name', Kind = 'junk' WHERE ItemID = 3;
+UPDATE Items SET Weight = NULL, Name = 'pie' WHERE Weight IS NULL;
+UPDATE Items SET Weight = ItemID, ItemID = Weight + 100 WHERE ItemID = 4;
+
+SELECT * FROM Items;
+SELECT * FROM Items WHERE Weight > 12;
+SELECT * FROM Items WHERE Kind = 'tool' AND Weight = 16;
+SELECT COUNT(*) FROM Items WHERE Kind = 'junk';
+SELECT * FROM Items WHERE ItemID = 107 OR Weight = 4;
+SELECT * FROM Items WHERE Name LIKE '%longer%';
+
+UPDATE Items SET ItemID = 1, Weight = 0 WHERE ItemID = 2;
+UPDATE Items SET Weight = 1, Weight = 2 WHERE ItemID = 2;
+UPDATE Items SET Weight = 1, Missing = 2 WHERE ItemID = 2;
+
+SELECT * FROM Items WHERE ItemID <= 2;
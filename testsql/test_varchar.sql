@@ -0,0 +1,49 @@
+CREATE DATABASE db_varchar;
+USE db_varchar;
+
+CREATE TABLE Notes (
+    NoteID int,
+    Tag varchar(1000),
+    Body varchar(3000),
+    Score float,
+    PRIMARY KEY (NoteID));
+
+CREATE TABLE Tags (
+    Name varchar(1000),
+    Label varchar(20));
+
+INSERT INTO Notes VALUES
+(1, 'tag1', 'b1', 1.25),
+(2, 'tag2', 'b2', 2.25),
+(3, 'tag3', 'b3 qqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqq', 23.25),
+(4, 'tag1', NULL, 4.25),
+(5, NULL, 'b5', 5.25),
+(6, '', 'b6', 26.25),
+(7, 'tag2', 'b1 again', 7.25),
+(8, 'tag3', '', 8.25);
+
+INSERT INTO Tags VALUES ('tag1', 'one'), ('tag2', 'two'), ('tag3', 'three'), ('', 'empty');
+
+CREATE INDEX Notes(Tag);
+CREATE INDEX Tags(Name);
+
+SELECT NoteID, Tag FROM Notes WHERE Tag = 'tag2';
+SELECT NoteID FROM Notes WHERE Tag IS NULL;
+SELECT NoteID FROM Notes WHERE Tag = '';
+SELECT NoteID, Score FROM Notes WHERE Body LIKE 'b3%';
+
+SELECT Notes.NoteID, Tags.Label FROM Notes, Tags
+    WHERE Notes.Tag = Tags.Name AND Notes.Score < 12.0;
+
+UPDATE Notes SET Tag = 'a much longer tag than before' WHERE NoteID < 3;
+UPDATE Notes SET Body = 'short' WHERE Score > 20.0;
+UPDATE Notes SET Tag = NULL WHERE NoteID = 7;
+UPDATE Notes SET Tag = 'tag0' WHERE Tag IS NULL;
+
+SELECT NoteID, Tag FROM Notes WHERE Tag = 'a much longer tag than before';
+SELECT NoteID, Tag FROM Notes WHERE Tag = 'tag0';
+SELECT NoteID, Body FROM Notes WHERE Body = 'short';
+SELECT COUNT(*) FROM Notes WHERE Body LIKE 'b1%';
+
+DELETE FROM Notes WHERE Tag = 'tag3';
+SELECT * FROM Notes;
@@ -0,0 +1,33 @@
+CREATE DATABASE db;
+
+USE db;
+
+CREATE TABLE Events (
+   EventID int,
+   Day date,
+   Level int,
+   Cost float,
+   Note varchar(100),
+   PRIMARY KEY (EventID));
+
+LOAD DATA INFILE 'testsql/test_zone_map.csv' INTO TABLE Events;
+
+SELECT EventID, Day FROM Events WHERE Day = '2021-01-05';
+SELECT EventID, Day FROM Events WHERE Day >= '2021-04-08' AND Day < '2021-04-10';
+SELECT EventID, Day FROM Events WHERE '2021-01-02' > Day;
+SELECT EventID FROM Events WHERE EventID > 190 AND Level = 3;
+SELECT EventID, Cost FROM Events WHERE Cost >= 48.5;
+SELECT EventID FROM Events WHERE Level IS NULL AND Day <= '2021-02-01';
+SELECT EventID FROM Events WHERE Day > '2022-01-01';
+
+UPDATE Events SET Day = '2023-06-01' WHERE EventID = 7;
+UPDATE Events SET Cost = 99.5 WHERE EventID = 100;
+SELECT EventID, Day FROM Events WHERE Day > '2022-01-01';
+SELECT EventID, Cost FROM Events WHERE Cost > 60.0;
+
+INSERT INTO Events VALUES (201, '2020-12-31', 1, 0.5, 'late');
+SELECT EventID, Day FROM Events WHERE Day < '2021-01-01';
+
+DELETE FROM Events WHERE Day < '2021-03-01';
+SELECT EventID, Day FROM Events WHERE Day < '2021-03-05';
+SELECT EventID, Day FROM Events WHERE Day > '2022-01-01';